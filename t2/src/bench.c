@@ -0,0 +1,89 @@
+// bench.c
+// executa a mesma carga com cada política de escalonamento e compara
+// simulador de computador
+// so24b
+
+// a carga é a do programa inicial (init.maq); cada política é executada em
+//   um computador novo, sem console (ligado com tela_nula.c), até não
+//   existirem mais processos
+// uso: bench [-p] [escalonador...]   (sem escalonadores, executa todas as
+//   políticas; com -p, mostra também o tempo real gasto em cada fase do SO)
+
+#include "hardware.h"
+#include "scheduler.h"
+#include "so.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// limite de instruções por execução, caso a carga não termine
+#define MAX_INSTRUCOES 10000000
+
+// mostra o tempo real gasto pelo SO em cada fase do tratamento de interrupção
+static void imprime_perfil(perfil_t *perfil)
+{
+  for (int f = 0; f < perfil_n_fases(perfil); f++) {
+    perfil_fase_t fase;
+    perfil_fase(perfil, f, &fase);
+    printf("  %-12s %7ld vezes %11lld ns  média %7lld ns  máx %9lld ns\n", fase.nome,
+           fase.n, fase.total_ns, fase.n ? fase.total_ns / fase.n : 0, fase.max_ns);
+  }
+}
+
+static void executa(char *escalonador, bool perfil)
+{
+  hardware_t hw;
+  hardware_cria(&hw);
+  // ninguém está olhando: os terminais não perdem tempo com animação
+  for (char t = 'A'; console_terminal(hw.console, t) != NULL; t++) {
+    terminal_define_modo(console_terminal(hw.console, t), terminal_instantaneo);
+  }
+  so_t *so = so_cria(hw.cpu, hw.mem, hw.mem_secundaria, hw.mmu, hw.es,
+                     hw.console, escalonador);
+  if (so == NULL) {
+    fprintf(stderr, "escalonador '%s' não existe\n", escalonador);
+    hardware_destroi(&hw);
+    return;
+  }
+
+  while (!so_terminou(so) && relogio_agora(hw.relogio) < MAX_INSTRUCOES) {
+    controle_executa_1(hw.controle);
+    console_tictac(hw.console);
+  }
+
+  so_metricas_t m;
+  so_metricas(so, &m);
+  float vazao = m.tempo_total > 0 ? 1000.0 * m.n_processos / m.tempo_total : 0;
+  printf("%-12s %6d %9d %11.3f %11.1f %8d %10.1f %7d%s",
+         so_escalonador(so), m.n_processos, m.tempo_total, vazao,
+         m.turnaround_medio, m.turnaround_p95, m.resposta_media,
+         m.n_trocas_de_contexto, so_terminou(so) ? "" : "  (não terminou)");
+  // com mensagens perdidas, o log_da_console desta execução está incompleto
+  long perdidas = console_mensagens_perdidas(hw.console);
+  if (perdidas > 0) printf("  (%ld msgs perdidas no log)", perdidas);
+  printf("\n");
+  if (perfil) imprime_perfil(so_perfil(so));
+
+  so_destroi(so);
+  hardware_destroi(&hw);
+}
+
+int main(int argc, char *argv[])
+{
+  printf("%-12s %6s %9s %11s %11s %8s %10s %7s\n", "escalonador", "procs",
+         "tempo", "vazão/kins", "turnaround", "p95", "resposta", "trocas");
+  bool perfil = false;
+  int primeiro = 1;
+  if (argc > 1 && strcmp(argv[1], "-p") == 0) {
+    perfil = true;
+    primeiro = 2;
+  }
+  if (argc > primeiro) {
+    for (int i = primeiro; i < argc; i++) executa(argv[i], perfil);
+  } else {
+    for (int i = 0; scheduler_policy_name(i) != NULL; i++) {
+      executa(scheduler_policy_name(i), perfil);
+    }
+  }
+  return 0;
+}
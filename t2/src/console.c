@@ -8,6 +8,7 @@
 #include "console.h"
 #include "terminal.h"
 #include "tela.h"
+#include "registro.h"
 
 #include <string.h>
 #include <stdarg.h>
@@ -15,6 +16,11 @@
 #include <stdio.h>
 #include <ctype.h>
 #include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#include <stdatomic.h>
 
 // CONSTANTES {{{1
 
@@ -30,28 +36,98 @@
 #define N_LIN_ENTRADA 1
 #define N_LIN_CONSOLE (N_LIN - N_LIN_TERM - N_LIN_STATUS - N_LIN_ENTRADA)
 
+// caracteres digitados e ainda não lidos que cada terminal guarda
+#define TAM_ENTRADA_TERM 1024
+
 // linha onde começa cada componente
 #define LINHA_TERM    0
 #define LINHA_STATUS  (LINHA_TERM + N_LIN_TERM)
 #define LINHA_CONSOLE (LINHA_STATUS + N_LIN_STATUS)
 #define LINHA_ENTRADA (LINHA_CONSOLE + N_LIN_CONSOLE)
 
-// números de comandos para o controlador que podem ser guardados na console
+// número de linhas digitadas que podem estar esperando a simulação
 #define N_CMD_EXT 10
 
+// intervalo entre desenhos da tela, em ms (uns 30 por segundo)
+#define MS_POR_QUADRO 33
+
+// número de comandos que podem ser definidos por console_define_comando
+#define N_CMD_DEF 4
+
+// de quantos em quantos tictacs os arquivos de entrada dos terminais são lidos
+#define TICTACS_ENTRADA_ARQ 100
+
 // DECLARAÇÃO {{{1
 
+// com tela, a console tem duas threads:
+// - a da simulação (a que chama console_tictac), dona dos terminais, das
+//   mensagens e do status;
+// - a da tela, que lê o teclado e desenha, dona de tudo que é curses e da
+//   linha sendo digitada.
+// elas não compartilham nada além de 'quadro' e 'linhas', sem travas:
+// - a tela pede um quadro ('quadro_pedido' = true); a simulação, quando vê o
+//   pedido, copia o que deve ser desenhado para 'quadro' e responde (false);
+//   só então a tela lê o quadro, e só pede outro depois de desenhá-lo
+// - as linhas digitadas vão da tela para a simulação por uma fila circular
+//   com um produtor e um consumidor ('ini_linhas' só é alterado pela
+//   simulação, 'fim_linhas' só pela tela)
+typedef struct {
+  char term[N_TERM][2][N_COL+1];
+  char status[N_COL+1];
+  char console[N_LIN_CONSOLE][N_COL+1];
+} quadro_t;
+
 struct console_t {
   terminal_t *term[N_TERM];
   int cor_txt[N_TERM];
   int cor_cursor[N_TERM];
   char txt_status[N_COL+1];
+  // as linhas de mensagem formam um buffer circular; a mais antiga está
+  //   em 'ini_console'
   char txt_console[N_LIN_CONSOLE][N_COL+1];
+  int ini_console;
   char txt_entrada[N_COL+1];
-  char fila_de_comandos_externos[N_CMD_EXT];
-  FILE *arquivo_de_log;
+  // o que está na tela, para só redesenhar as linhas que mudaram (thread
+  //   da tela)
+  char na_tela[N_LIN][N_COL+1];
+  // comando externo de uma linha interpretada pela simulação, esperando
+  //   console_comando_externo
+  char comando_externo;
+  // comunicação entre as threads
+  quadro_t quadro;
+  atomic_bool quadro_pedido;
+  char linhas[N_CMD_EXT][N_COL+1];
+  atomic_int ini_linhas;
+  atomic_int fim_linhas;
+  atomic_int ms_por_quadro;
+  atomic_bool fim_da_tela;
+  pthread_t thread_da_tela;
+  struct {
+    char cmd;
+    func_comando_t func;
+    void *arg;
+  } comandos_definidos[N_CMD_DEF];
+  // as mensagens também vão para o arquivo log_da_console
+  registro_t *registro;
+  // sem tela, as mensagens só vão para o log e nada é desenhado
+  bool sem_tela;
+  // script com os comandos do operador (NULL se vêm do teclado), e quantos
+  //   tictacs esperar antes de ler a próxima linha dele
+  FILE *script;
+  int espera_script;
+  // arquivos de onde vem a entrada (-1 se não tem) e para onde vai cópia da
+  //   saída (NULL se não tem) de cada terminal
+  int entrada_arq[N_TERM];
+  bool entrada_fifo[N_TERM];
+  FILE *saida_arq[N_TERM];
+  int tictacs_entrada;
 };
 
+// funções da thread da tela
+static void *laco_da_tela(void *arg);
+static void monta_quadro(console_t *self);
+static void console_desenha(console_t *self);
+
 // CRIAÇÃO {{{1
 
 static console_t *console_global; // gambiarra para simplificar o uso de prints na console
@@ -62,7 +138,7 @@ console_t *console_cria(void)
   console_global = self;
 
   for (int t = 0; t < N_TERM; t++) {
-    self->term[t] = terminal_cria(N_COL);
+    self->term[t] = terminal_cria(N_COL, TAM_ENTRADA_TERM);
     if ((t % 2) == 0) {
       self->cor_txt[t] = COR_TXT_PAR;
       self->cor_cursor[t] = COR_CURSOR_PAR;
@@ -70,33 +146,64 @@ console_t *console_cria(void)
       self->cor_txt[t] = COR_TXT_IMPAR;
       self->cor_cursor[t] = COR_CURSOR_IMPAR;
     }
+    self->entrada_arq[t] = -1;
+    self->entrada_fifo[t] = false;
+    self->saida_arq[t] = NULL;
   }
   for (int l = 0; l < N_LIN_CONSOLE; l++) {
     strcpy(self->txt_console[l], "");
   }
+  self->ini_console = 0;
   strcpy(self->txt_entrada, "");
-  self->fila_de_comandos_externos[0] = '\0';
-  self->arquivo_de_log = fopen("log_da_console", "w");
+  strcpy(self->txt_status, "");
+  for (int l = 0; l < N_LIN; l++) {
+    // nada do que é desenhado é igual a isso, a primeira vez desenha tudo
+    strcpy(self->na_tela[l], "\x01");
+  }
+  self->comando_externo = '\0';
+  atomic_init(&self->quadro_pedido, false);
+  atomic_init(&self->ini_linhas, 0);
+  atomic_init(&self->fim_linhas, 0);
+  atomic_init(&self->ms_por_quadro, MS_POR_QUADRO);
+  atomic_init(&self->fim_da_tela, false);
+  for (int i = 0; i < N_CMD_DEF; i++) {
+    self->comandos_definidos[i].cmd = '\0';
+  }
+  self->registro = registro_cria("log_da_console");
+  self->sem_tela = !tela_existe();
+  self->script = NULL;
+  self->espera_script = 0;
+  self->tictacs_entrada = 0;
 
   tela_init();
+  if (!self->sem_tela) {
+    pthread_create(&self->thread_da_tela, NULL, laco_da_tela, self);
+  }
 
   return self;
 }
 
-static void console_desenha(console_t *self);
-
 void console_destroi(console_t *self)
 {
-  console_desenha(self);
-  if (self->arquivo_de_log != NULL) fclose(self->arquivo_de_log);
-  tela_puts(COR_OCUPADO, "  digite ENTER para sair  ");
-  tela_atualiza();
-  while (tela_tecla() != '\n') {
-    ;
+  if (self->registro != NULL) registro_destroi(self->registro);
+  if (!self->sem_tela) {
+    // a partir daqui, a tela é desta thread
+    atomic_store(&self->fim_da_tela, true);
+    pthread_join(self->thread_da_tela, NULL);
+    monta_quadro(self);
+    console_desenha(self);
+    tela_puts(COR_OCUPADO, "  digite ENTER para sair  ");
+    tela_atualiza();
+    while (tela_tecla() != '\n') {
+      ;
+    }
   }
   tela_fim();
 
+  if (self->script != NULL) fclose(self->script);
   for (int t = 0; t < N_TERM; t++) {
+    if (self->entrada_arq[t] != -1) close(self->entrada_arq[t]);
+    if (self->saida_arq[t] != NULL) fclose(self->saida_arq[t]);
     terminal_destroi(self->term[t]);
   }
   free(self);
@@ -119,9 +226,10 @@ static void atualiza_terminais(console_t *self)
   }
 }
 
-static void insere_string_no_terminal(console_t *self, char id_terminal, char *str)
+static void insere_string_no_terminal(console_t *self, char id_terminal, char *str,
+                                      char fim)
 {
-  // insere caracteres no terminal (e espaço no final)
+  // insere caracteres no terminal (e 'fim' no final)
   terminal_t *terminal = console_terminal(self, id_terminal);
   if (terminal == NULL) {
     console_printf("Terminal '%c' inválido\n", id_terminal);
@@ -132,7 +240,7 @@ static void insere_string_no_terminal(console_t *self, char id_terminal, char *s
     terminal_insere_char(terminal, *p);
     p++;
   }
-  terminal_insere_char(terminal, ' ');
+  terminal_insere_char(terminal, fim);
 }
 
 static void limpa_saida_do_terminal(console_t *self, char id_terminal)
@@ -145,19 +253,101 @@ static void limpa_saida_do_terminal(console_t *self, char id_terminal)
   terminal_limpa_saida(terminal);
 }
 
+bool console_entrada_do_terminal(console_t *self, char id_terminal, char *nome)
+{
+  int num_terminal = tolower(id_terminal) - 'a';
+  if (num_terminal < 0 || num_terminal >= N_TERM) return false;
+  // não bloqueante, para não parar a simulação esperando quem escreve no fifo
+  int fd = open(nome, O_RDONLY | O_NONBLOCK);
+  if (fd == -1) return false;
+  struct stat st;
+  if (self->entrada_arq[num_terminal] != -1) close(self->entrada_arq[num_terminal]);
+  self->entrada_arq[num_terminal] = fd;
+  self->entrada_fifo[num_terminal] = fstat(fd, &st) == 0 && S_ISFIFO(st.st_mode);
+  return true;
+}
+
+bool console_saida_do_terminal(console_t *self, char id_terminal, char *nome)
+{
+  int num_terminal = tolower(id_terminal) - 'a';
+  if (num_terminal < 0 || num_terminal >= N_TERM) return false;
+  FILE *arq = fopen(nome, "w");
+  if (arq == NULL) return false;
+  if (self->saida_arq[num_terminal] != NULL) fclose(self->saida_arq[num_terminal]);
+  self->saida_arq[num_terminal] = arq;
+  terminal_define_copia_saida(self->term[num_terminal], arq);
+  return true;
+}
+
+// passa para os terminais o que já chegou nos seus arquivos de entrada,
+//   até onde couber
+static void le_entrada_dos_arquivos(console_t *self)
+{
+  if (++self->tictacs_entrada < TICTACS_ENTRADA_ARQ) return;
+  self->tictacs_entrada = 0;
+  for (int t = 0; t < N_TERM; t++) {
+    if (self->entrada_arq[t] == -1) continue;
+    char buf[TAM_ENTRADA_TERM];
+    int n = terminal_espaco_entrada(self->term[t]);
+    if (n == 0) continue;
+    n = read(self->entrada_arq[t], buf, n);
+    for (int i = 0; i < n; i++) {
+      terminal_insere_char(self->term[t], buf[i]);
+    }
+    // fim de arquivo; um fifo sem ninguém escrevendo pode ganhar escritor depois
+    if (n == 0 && !self->entrada_fifo[t]) {
+      close(self->entrada_arq[t]);
+      self->entrada_arq[t] = -1;
+    }
+  }
+}
+
+// mostra na console as linhas do histórico do terminal, da mais antiga
+static void mostra_historico_do_terminal(console_t *self, char id_terminal)
+{
+  terminal_t *terminal = console_terminal(self, id_terminal);
+  if (terminal == NULL) {
+    console_printf("Terminal '%c' inválido\n", id_terminal);
+    return;
+  }
+  int n = terminal_n_historico(terminal);
+  console_printf("Terminal '%c': %d linhas no histórico", id_terminal, n);
+  for (int i = n - 1; i >= 0; i--) {
+    console_printf("%c| %s", id_terminal, terminal_historico(terminal, i));
+  }
+}
+
+static void alterna_modo_do_terminal(console_t *self, char id_terminal)
+{
+  terminal_t *terminal = console_terminal(self, id_terminal);
+  if (terminal == NULL) {
+    console_printf("Terminal '%c' inválido\n", id_terminal);
+    return;
+  }
+  if (terminal_modo(terminal) == terminal_animado) {
+    terminal_define_modo(terminal, terminal_instantaneo);
+    console_printf("Terminal '%c' com saída instantânea", id_terminal);
+  } else {
+    terminal_define_modo(terminal, terminal_animado);
+    console_printf("Terminal '%c' com saída animada", id_terminal);
+  }
+}
+
 // SAÍDA {{{1
 
 static void insere_string_na_console(console_t *self, char *s)
 {
-  for(int l=0; l<N_LIN_CONSOLE-1; l++) {
-    strncpy(self->txt_console[l], self->txt_console[l+1], N_COL);
-    self->txt_console[l][N_COL] = '\0'; // quem definiu strncpy é estúpido!
-  }
-  strncpy(self->txt_console[N_LIN_CONSOLE-1], s, N_COL);
-  self->txt_console[N_LIN_CONSOLE-1][N_COL] = '\0'; // grrrr
-  if (self->arquivo_de_log != NULL) {
-    fprintf(self->arquivo_de_log, "%s\n", s);
+  if (self->sem_tela) {
+    // ninguém vai ver a tela, só o log
+    if (self->registro != NULL) registro_escreve(self->registro, s);
+    return;
   }
+  // a nova linha substitui a mais antiga, que passa a ser a seguinte
+  char *linha = self->txt_console[self->ini_console];
+  strncpy(linha, s, N_COL);
+  linha[N_COL] = '\0'; // quem definiu strncpy é estúpido!
+  self->ini_console = (self->ini_console + 1) % N_LIN_CONSOLE;
+  if (self->registro != NULL) registro_escreve(self->registro, s);
 }
 
 static void insere_strings_na_console(console_t *self, char *s)
@@ -181,6 +371,12 @@ void console_print_status(console_t *self, char *txt)
   sprintf(self->txt_status, "%-*s", N_COL, txt);
 }
 
+long console_mensagens_perdidas(console_t *self)
+{
+  if (self->registro == NULL) return 0;
+  return registro_perdidas(self->registro);
+}
+
 int console_printf(char *formato, ...)
 {
   // esta função usa número variável de argumentos, como o printf.
@@ -197,65 +393,158 @@ int console_printf(char *formato, ...)
 
 // ENTRADA {{{1
 
-static void insere_comando_externo(console_t *self, char c)
+// insere uma linha digitada na fila para a simulação (thread da tela)
+// retorna false se a fila estiver cheia
+static bool insere_linha(console_t *self, char *linha)
 {
-  int n_cmd = strlen(self->fila_de_comandos_externos);
-  if (n_cmd < N_CMD_EXT - 2) {
-    self->fila_de_comandos_externos[n_cmd] = c;
-    self->fila_de_comandos_externos[n_cmd+1] = '\0';
+  int fim = atomic_load_explicit(&self->fim_linhas, memory_order_relaxed);
+  int ini = atomic_load_explicit(&self->ini_linhas, memory_order_acquire);
+  if (fim - ini == N_CMD_EXT) return false;
+  strcpy(self->linhas[fim % N_CMD_EXT], linha);
+  atomic_store_explicit(&self->fim_linhas, fim + 1, memory_order_release);
+  return true;
+}
+
+// retira a próxima linha digitada da fila, copiando para 'linha'
+//   (thread da simulação); retorna false se não tem
+static bool remove_linha(console_t *self, char *linha)
+{
+  int ini = atomic_load_explicit(&self->ini_linhas, memory_order_relaxed);
+  int fim = atomic_load_explicit(&self->fim_linhas, memory_order_acquire);
+  if (ini == fim) return false;
+  strcpy(linha, self->linhas[ini % N_CMD_EXT]);
+  atomic_store_explicit(&self->ini_linhas, ini + 1, memory_order_release);
+  return true;
+}
+
+void console_define_comando(console_t *self, char cmd, func_comando_t func, void *arg)
+{
+  cmd = toupper(cmd);
+  int livre = -1;
+  for (int i = 0; i < N_CMD_DEF; i++) {
+    if (self->comandos_definidos[i].cmd == cmd) {
+      livre = i;
+      break;
+    }
+    if (livre == -1 && self->comandos_definidos[i].cmd == '\0') livre = i;
   }
+  if (livre == -1) {
+    console_printf("Sem espaço para definir o comando '%c'", cmd);
+    return;
+  }
+  self->comandos_definidos[livre].cmd = func == NULL ? '\0' : cmd;
+  self->comandos_definidos[livre].func = func;
+  self->comandos_definidos[livre].arg = arg;
 }
 
-static char remove_comando_externo(console_t *self)
+// executa o comando definido por console_define_comando; retorna false se não tem
+static bool executa_comando_definido(console_t *self, char cmd)
 {
-  char *p = self->fila_de_comandos_externos;
-  char cmd = *p;
-  if (cmd != '\0') {
-    memmove(p, p+1, strlen(p));
+  for (int i = 0; i < N_CMD_DEF; i++) {
+    if (self->comandos_definidos[i].cmd == cmd) {
+      self->comandos_definidos[i].func(self->comandos_definidos[i].arg);
+      return true;
+    }
   }
-  return cmd;
+  return false;
 }
 
-static void interpreta_linha_entrada(console_t *self)
+// retorna o comando externo da linha, ou '\0' se não for um
+static char interpreta_linha(console_t *self, char *linha)
 {
-  // interpreta uma linha digitada pelo operador
+  // interpreta uma linha digitada pelo operador (thread da simulação)
   // Comandos aceitos:
   // Etstr entra a string 'str' no terminal 't'  ex: eb30
+  // Ltstr entra a linha 'str' (terminada por '\n') no terminal 't'  ex: la oi
   // Zt    esvazia a saída do terminal 't'  ex: za
-  // Dn    altera o tempo de espera do teclado  ex: d0  -> modo turbo
+  // It    alterna a saída do terminal 't' entre animada e instantânea  ex: ia
+  // Ht    mostra o histórico (modo instantâneo) do terminal 't'  ex: ha
+  // Dn    altera o intervalo entre desenhos da tela para n ms  ex: d100
+  // Wn    espera n tictacs antes de ler a próxima linha do script  ex: w5000
   // P     para a execução
   // 1     executa uma instrução
   // C     continua a execução
   // F     fim da simulação
+  // outros comandos podem ser definidos com console_define_comando
 
-  char *linha = self->txt_entrada;
+  if (linha[0] == '\0') return '\0';
   console_printf("CMD: '%s'", linha);
   char cmd = toupper(linha[0]);
   int val;
   switch (cmd) {
     case 'E':
-      insere_string_no_terminal(self, linha[1], &linha[2]);
+      insere_string_no_terminal(self, linha[1], &linha[2], ' ');
+      break;
+    case 'L':
+      insere_string_no_terminal(self, linha[1], &linha[2], '\n');
       break;
     case 'Z':
       limpa_saida_do_terminal(self, linha[1]);
       break;
+    case 'I':
+      alterna_modo_do_terminal(self, linha[1]);
+      break;
+    case 'H':
+      mostra_historico_do_terminal(self, linha[1]);
+      break;
     case 'D':
       val = atoi(&linha[1]);
-      tela_espera(val);
+      atomic_store(&self->ms_por_quadro, val > 0 ? val : 1);
+      break;
+    case 'W':
+      self->espera_script = atoi(&linha[1]);
       break;
     case 'P':
     case '1':
     case 'C':
     case 'F':
-      insere_comando_externo(self, cmd);
-      break;
+      return cmd;
     default:
-      console_printf("Comando '%c' não reconhecido", cmd);
+      if (!executa_comando_definido(self, cmd)) {
+        console_printf("Comando '%c' não reconhecido", cmd);
+      }
   }
-  strcpy(self->txt_entrada, "");
+  return '\0';
 }
 
-// lê e guarda um caractere do teclado; interpreta linha se for 'enter'
+void console_comando(console_t *self, char *linha)
+{
+  char aux[N_COL+1];
+  strncpy(aux, linha, N_COL);
+  aux[N_COL] = '\0';
+  char cmd = interpreta_linha(self, aux);
+  if (cmd != '\0') self->comando_externo = cmd;
+}
+
+bool console_define_script(console_t *self, char *nome)
+{
+  FILE *arq = fopen(nome, "r");
+  if (arq == NULL) return false;
+  if (self->script != NULL) fclose(self->script);
+  self->script = arq;
+  self->espera_script = 0;
+  return true;
+}
+
+// interpreta a próxima linha do script, se não estiver esperando
+static void le_linha_do_script(console_t *self)
+{
+  if (self->espera_script > 0) {
+    self->espera_script--;
+    return;
+  }
+  char linha[N_COL + 2];
+  if (fgets(linha, sizeof(linha), self->script) == NULL) {
+    fclose(self->script);
+    self->script = NULL;
+    return;
+  }
+  linha[strcspn(linha, "\r\n")] = '\0';
+  console_comando(self, linha);
+}
+
+// lê e guarda um caractere do teclado; manda a linha para a simulação se
+//   for 'enter' (thread da tela)
 static void verifica_entrada(console_t *self)
 {
   char ch = tela_tecla();
@@ -267,7 +556,8 @@ static void verifica_entrada(console_t *self)
       self->txt_entrada[l - 1] = '\0';
     }
   } else if (ch == '\n') {
-    interpreta_linha_entrada(self);
+    // se a fila estiver cheia, a linha fica aí para o operador tentar de novo
+    if (insere_linha(self, self->txt_entrada)) strcpy(self->txt_entrada, "");
   } else if (ch >= ' ' && ch < 127 && l < N_COL) {
     self->txt_entrada[l] = ch;
     self->txt_entrada[l+1] = '\0';
@@ -276,14 +566,31 @@ static void verifica_entrada(console_t *self)
 
 char console_comando_externo(console_t *self)
 {
-  verifica_entrada(self);
-  return remove_comando_externo(self);
+  char cmd = self->comando_externo;
+  if (cmd != '\0') {
+    self->comando_externo = '\0';
+    return cmd;
+  }
+  char linha[N_COL+1];
+  if (remove_linha(self, linha)) return interpreta_linha(self, linha);
+  return '\0';
 }
 
 // DESENHO {{{1
 
-static void desenha_linha_terminal(char *txt, int linha, int cor_txt, int cor_cursor)
+// retorna true se 'txt' não é o que está desenhado na linha, e registra que
+//   passa a ser
+static bool linha_mudou(console_t *self, int linha, char *txt)
+{
+  if (strcmp(self->na_tela[linha], txt) == 0) return false;
+  strcpy(self->na_tela[linha], txt);
+  return true;
+}
+
+static void desenha_linha_terminal(console_t *self, char *txt, int linha,
+                                   int cor_txt, int cor_cursor)
 {
+  if (!linha_mudou(self, linha, txt)) return;
   tela_posiciona(linha, 0);
   tela_puts(cor_txt, txt);
   tela_limpa_linha();
@@ -293,34 +600,40 @@ static void desenha_linha_terminal(char *txt, int linha, int cor_txt, int cor_cu
 static void desenha_terminais(console_t *self)
 {
   for (int t = 0; t < N_TERM; t++) {
-    terminal_t *terminal = self->term[t];
     int cor_txt = self->cor_txt[t];
     int cor_cursor = self->cor_cursor[t];
     int linha = LINHA_TERM + t * 2;
-    desenha_linha_terminal(terminal_txt_entrada(terminal), linha, cor_txt, cor_cursor);
-    desenha_linha_terminal(terminal_txt_saida(terminal), linha+1, cor_txt, cor_cursor);
+    desenha_linha_terminal(self, self->quadro.term[t][0], linha, cor_txt, cor_cursor);
+    desenha_linha_terminal(self, self->quadro.term[t][1], linha+1, cor_txt, cor_cursor);
   }
 }
 
 static void desenha_status(console_t *self)
 {
+  if (!linha_mudou(self, LINHA_STATUS, self->quadro.status)) return;
   tela_posiciona(LINHA_STATUS, 0);
-  tela_puts(COR_STATUS, self->txt_status);
+  tela_puts(COR_STATUS, self->quadro.status);
   tela_limpa_linha();
 }
 
 static void desenha_console(console_t *self)
 {
   for (int l=0; l<N_LIN_CONSOLE; l++) {
+    if (!linha_mudou(self, LINHA_CONSOLE + l, self->quadro.console[l])) continue;
     tela_posiciona(LINHA_CONSOLE + l, 0);
-    tela_puts(COR_CONSOLE, self->txt_console[l]);
+    tela_puts(COR_CONSOLE, self->quadro.console[l]);
     tela_limpa_linha();
   }
 }
 
 static void desenha_entrada(console_t *self)
 {
-  char txt_fixo[] = "P=para C=continua 1=passo F=fim  Ets=entra Zt=zera";
+  char txt_fixo[] = "P=para C=continua 1=passo F=fim  Ets=entra Zt=zera Ht=hist";
+  if (!linha_mudou(self, LINHA_ENTRADA, self->txt_entrada)) {
+    // o cursor fica onde o operador está digitando
+    tela_posiciona(LINHA_ENTRADA, strlen(self->txt_entrada));
+    return;
+  }
   tela_posiciona(LINHA_ENTRADA, 0);
   tela_puts(COR_ENTRADA, ""); // gambiarra para limpar na cor certa
   tela_limpa_linha();
@@ -337,16 +650,69 @@ static void console_desenha(console_t *self)
   desenha_console(self);
   desenha_entrada(self);
 
-  // faz aparecer tudo que foi desenhado
+  // faz aparecer tudo que foi desenhado (o curses só manda o que mudou)
   tela_atualiza();
 }
 
+// THREAD DA TELA {{{1
+
+static void *laco_da_tela(void *arg)
+{
+  console_t *self = arg;
+  int ms = -1;
+  atomic_store_explicit(&self->quadro_pedido, true, memory_order_release);
+  while (!atomic_load(&self->fim_da_tela)) {
+    // desenha o quadro, se a simulação já respondeu, e pede outro
+    if (!atomic_load_explicit(&self->quadro_pedido, memory_order_acquire)) {
+      console_desenha(self);
+      atomic_store_explicit(&self->quadro_pedido, true, memory_order_release);
+    }
+    // o teclado é esperado no máximo até a hora do próximo quadro
+    if (atomic_load(&self->ms_por_quadro) != ms) {
+      ms = atomic_load(&self->ms_por_quadro);
+      tela_espera(ms);
+    }
+    verifica_entrada(self);
+  }
+  return NULL;
+}
+
+// copia para o quadro o que deve ser desenhado (thread da simulação)
+static void monta_quadro(console_t *self)
+{
+  for (int t = 0; t < N_TERM; t++) {
+    terminal_t *terminal = self->term[t];
+    strcpy(self->quadro.term[t][0], terminal_txt_entrada(terminal));
+    // no modo instantâneo a saída quase sempre está vazia (as linhas vão
+    //   direto para o histórico); mostra a última linha completa
+    char *saida = terminal_txt_saida(terminal);
+    if (saida[0] == '\0' && terminal_n_historico(terminal) > 0) {
+      saida = terminal_historico(terminal, 0);
+    }
+    strcpy(self->quadro.term[t][1], saida);
+  }
+  strcpy(self->quadro.status, self->txt_status);
+  for (int l = 0; l < N_LIN_CONSOLE; l++) {
+    int i = (self->ini_console + l) % N_LIN_CONSOLE;
+    strcpy(self->quadro.console[l], self->txt_console[i]);
+  }
+}
+
+bool console_quer_status(console_t *self)
+{
+  return atomic_load_explicit(&self->quadro_pedido, memory_order_relaxed);
+}
+
 // TICTAC {{{1
 void console_tictac(console_t *self)
 {
-  verifica_entrada(self);
+  if (self->script != NULL) le_linha_do_script(self);
+  le_entrada_dos_arquivos(self);
   atualiza_terminais(self);
-  console_desenha(self);
+  if (atomic_load_explicit(&self->quadro_pedido, memory_order_acquire)) {
+    monta_quadro(self);
+    atomic_store_explicit(&self->quadro_pedido, false, memory_order_release);
+  }
 }
 
 // vim: foldmethod=marker
@@ -23,7 +23,14 @@ int console_printf(char *fmt, ...);
 // imprime na linha de status
 void console_print_status(console_t *self, char *txt);
 
+// número de mensagens da console que não foram para o log_da_console porque
+//   o buffer do registro estava cheio (ver registro.h)
+long console_mensagens_perdidas(console_t *self);
+
 // retorna o próximo comando externo digitado pelo operador na console.
+// com tela, o teclado é lido e a tela desenhada por outra thread, umas 30
+//   vezes por segundo; as linhas digitadas só são interpretadas aqui (e em
+//   console_tictac), na thread que executa a simulação.
 // um comando externo é representado por um caractere, e não é executado internamente
 //   na console (é executado pelo controlador).
 // os comandos externos são:
@@ -34,10 +41,41 @@ void console_print_status(console_t *self, char *txt);
 // retorna '\0' caso não tenha comando externo digitado
 char console_comando_externo(console_t *self);
 
+// tipo da função a ser chamada para um comando definido fora da console
+typedef void (*func_comando_t)(void *arg);
+
+// define a função a chamar (com o argumento 'arg') quando o operador digitar
+//   o comando 'cmd', uma letra que não seja um dos comandos da console
+// se 'func' for NULL, o comando deixa de existir
+void console_define_comando(console_t *self, char cmd, func_comando_t func, void *arg);
+
+// interpreta 'linha' como se tivesse sido digitada pelo operador
+void console_comando(console_t *self, char *linha);
+
+// os comandos do operador passam a vir do arquivo 'nome', uma linha por
+//   tictac, em vez do teclado (até o fim do arquivo)
+// no script, o comando 'Wn' espera n tictacs antes da próxima linha
+// retorna false se não conseguir abrir o arquivo
+bool console_define_script(console_t *self, char *nome);
+
 // retorna o terminal identificado ('A', 'B', etc)
 terminal_t *console_terminal(console_t *self, char id_terminal);
 
+// o que for escrito no arquivo (ou fifo) 'nome' é digitado no terminal,
+//   como pelo comando 'E'; o arquivo é lido periodicamente, sem bloquear
+// retorna false se o terminal não existe ou o arquivo não pode ser aberto
+bool console_entrada_do_terminal(console_t *self, char id_terminal, char *nome);
+
+// tudo que for escrito na saída do terminal é copiado para o arquivo 'nome'
+// retorna false se o terminal não existe ou o arquivo não pode ser criado
+bool console_saida_do_terminal(console_t *self, char id_terminal, char *nome);
+
 // esta função deve ser chamada periodicamente para que tela funcione
+// é nela que é copiado o que a tela vai desenhar, quando a tela pede
 void console_tictac(console_t *self);
 
+// retorna true se a tela está esperando um quadro novo; a linha de status
+//   só precisa ser atualizada (console_print_status) nessa hora
+bool console_quer_status(console_t *self);
+
 #endif // CONSOLE_H
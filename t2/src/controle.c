@@ -9,11 +9,15 @@
 #include <string.h>
 #include <stdio.h>
 #include <assert.h>
+#include <unistd.h>
 
 struct controle_t {
   cpu_t *cpu;
   relogio_t *relogio;
+  pic_t *pic;
   console_t *console;
+  func_fim_t func_fim;
+  void *arg_fim;
   enum { executando, passo, parado, fim } estado;
 };
 
@@ -22,7 +26,8 @@ static void controle_processa_comandos_da_console(controle_t *self);
 static void controle_atualiza_estado_na_console(controle_t *self);
 
 
-controle_t *controle_cria(cpu_t *cpu, console_t *console, relogio_t *relogio)
+controle_t *controle_cria(cpu_t *cpu, console_t *console, relogio_t *relogio,
+                          pic_t *pic)
 {
   controle_t *self = malloc(sizeof(*self));
   assert(self != NULL);
@@ -30,6 +35,9 @@ controle_t *controle_cria(cpu_t *cpu, console_t *console, relogio_t *relogio)
   self->cpu = cpu;
   self->console = console;
   self->relogio = relogio;
+  self->pic = pic;
+  self->func_fim = NULL;
+  self->arg_fim = NULL;
   self->estado = parado;
 
   return self;
@@ -40,28 +48,34 @@ void controle_destroi(controle_t *self)
   free(self);
 }
 
+void controle_define_fim(controle_t *self, func_fim_t func, void *arg)
+{
+  self->func_fim = func;
+  self->arg_fim = arg;
+}
+
 void controle_laco(controle_t *self)
 {
   // executa uma instrução por vez até a console dizer que chega
   do {
     if (self->estado == passo || self->estado == executando) {
-      cpu_executa_1(self->cpu);
-      relogio_tictac(self->relogio);
+      controle_executa_1(self);
 
       if (self->estado == passo) self->estado = parado;
-
-      // enquanto não tem controlador de interrupção, fala direto com o relógio
-      // o dispositivo 3 do relógio contém 1 se o timer expirou
-      int tem_int;
-      relogio_leitura(self->relogio, 3, &tem_int);
-      if (tem_int != 0) {
-        cpu_interrompe(self->cpu, IRQ_RELOGIO);
-      }
     }
-    console_tictac(self->console);
 
     controle_processa_comandos_da_console(self);
-    controle_atualiza_estado_na_console(self);
+    if (self->func_fim != NULL && self->func_fim(self->arg_fim)) {
+      self->estado = fim;
+    }
+    // a descrição da CPU só é feita quando a tela vai mostrar, e tem que
+    //   estar pronta antes de console_tictac montar o quadro
+    if (console_quer_status(self->console)) {
+      controle_atualiza_estado_na_console(self);
+    }
+    console_tictac(self->console);
+    // parado, não tem o que fazer além de esperar o operador
+    if (self->estado == parado) usleep(1000);
   } while (self->estado != fim);
 
   console_printf("Fim da execução.");
@@ -69,6 +83,19 @@ void controle_laco(controle_t *self)
 }
  
 
+void controle_executa_1(controle_t *self)
+{
+  cpu_executa_1(self->cpu);
+  relogio_tictac(self->relogio);
+
+  // o controlador de interrupções diz se algum dispositivo pediu interrupção
+  // se a CPU não aceitar agora, o pedido continua pendente e é repetido
+  int irq = pic_irq(self->pic);
+  if (irq >= 0) {
+    cpu_interrompe(self->cpu, irq);
+  }
+}
+
 static void controle_processa_comandos_da_console(controle_t *self)
 {
   char cmd = console_comando_externo(self->console);
@@ -11,11 +11,25 @@ typedef struct controle_t controle_t;
 #include "cpu.h"
 #include "console.h"
 #include "relogio.h"
+#include "pic.h"
 
-controle_t *controle_cria(cpu_t *cpu, console_t *console, relogio_t *relogio);
+controle_t *controle_cria(cpu_t *cpu, console_t *console, relogio_t *relogio,
+                          pic_t *pic);
 void controle_destroi(controle_t *self);
 
+// tipo da função que diz se a simulação deve terminar
+typedef bool (*func_fim_t)(void *arg);
+
+// define uma função a ser chamada (com o argumento 'arg') a cada volta do laço
+//   principal; o laço termina quando ela retornar true, como se o operador
+//   tivesse digitado 'F'
+void controle_define_fim(controle_t *self, func_fim_t func, void *arg);
+
 // o laço principal da simulação
 void controle_laco(controle_t *self);
 
+// executa uma instrução e faz o relógio andar, sem passar pela console
+// (para quem controla a simulação sem o laço principal)
+void controle_executa_1(controle_t *self);
+
 #endif // CONTROLE_H
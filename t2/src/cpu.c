@@ -33,6 +33,9 @@ struct cpu_t {
   // função e argumento para implementar instrução CHAMAC
   func_chamaC_t funcaoC;
   void *argC;
+  // onde o estado é salvo nas interrupções, e o banco usado se não for na memória
+  cpu_salvamento_t salvamento;
+  cpu_contexto_t banco;
 };
 
 // CRIAÇÃO {{{1
@@ -52,6 +55,7 @@ cpu_t *cpu_cria(mmu_t *mmu, es_t *es)
   self->complemento = 0;
   self->modo = usuario;
   self->funcaoC = NULL;
+  self->salvamento = cpu_salva_na_memoria;
   // inicializa instruções privilegiadas
   memset(self->privilegiadas, 0, sizeof(self->privilegiadas));
   self->privilegiadas[PARA] = true;
@@ -493,16 +497,28 @@ bool cpu_interrompe(cpu_t *self, irq_t irq)
   //   acesso (para quando existir proteção de memória)
   self->modo = supervisor;
 
-  // esta é uma CPU boazinha, salva todo o estado interno da CPU no início da memória
-  // self->erro é alterado por poe_mem, copia antes!
-  int erro = self->erro;
-  int complemento = self->complemento;
-  poe_mem(self, IRQ_END_PC,          self->PC);
-  poe_mem(self, IRQ_END_A,           self->A);
-  poe_mem(self, IRQ_END_X,           self->X);
-  poe_mem(self, IRQ_END_erro,        erro);
-  poe_mem(self, IRQ_END_complemento, complemento);
-  poe_mem(self, IRQ_END_modo,        usuario);
+  // esta é uma CPU boazinha, salva todo o estado interno da CPU no banco ou
+  //   no início da memória
+  if (self->salvamento == cpu_salva_no_banco) {
+    self->banco = (cpu_contexto_t) {
+      .PC = self->PC,
+      .A = self->A,
+      .X = self->X,
+      .erro = self->erro,
+      .complemento = self->complemento,
+      .modo = usuario,
+    };
+  } else {
+    // self->erro é alterado por poe_mem, copia antes!
+    int erro = self->erro;
+    int complemento = self->complemento;
+    poe_mem(self, IRQ_END_PC,          self->PC);
+    poe_mem(self, IRQ_END_A,           self->A);
+    poe_mem(self, IRQ_END_X,           self->X);
+    poe_mem(self, IRQ_END_erro,        erro);
+    poe_mem(self, IRQ_END_complemento, complemento);
+    poe_mem(self, IRQ_END_modo,        usuario);
+  }
 
   // altera o estado da CPU para ela poder executar o tratador de interrupção
   // vai iniciar o tratamento da interrupção no endereço IRQ_END_TRATADOR,
@@ -522,6 +538,16 @@ static void cpu_desinterrompe(cpu_t *self)
   // recupera o estado da CPU, para que volte a executar o que foi interrompido
   //   quando a interrupção foi atendida
   
+  if (self->salvamento == cpu_salva_no_banco) {
+    self->PC = self->banco.PC;
+    self->A = self->banco.A;
+    self->X = self->banco.X;
+    self->complemento = self->banco.complemento;
+    self->modo = self->banco.modo;
+    self->erro = self->banco.erro;
+    return;
+  }
+
   // tem que estar em modo supervisor para ler nesses endereços
   self->modo = supervisor;
   pega_mem(self, IRQ_END_PC,          &self->PC);
@@ -537,4 +563,43 @@ static void cpu_desinterrompe(cpu_t *self)
   self->erro = erro;
 }
 
+// CONTEXTO SALVO {{{1
+
+void cpu_define_salvamento(cpu_t *self, cpu_salvamento_t salvamento)
+{
+  self->salvamento = salvamento;
+}
+
+void cpu_le_contexto(cpu_t *self, cpu_contexto_t *contexto)
+{
+  if (self->salvamento == cpu_salva_no_banco) {
+    *contexto = self->banco;
+    return;
+  }
+  // o estado está na memória física, acessível em modo supervisor
+  int erro, modo;
+  mmu_le(self->mmu, IRQ_END_PC,          &contexto->PC, supervisor);
+  mmu_le(self->mmu, IRQ_END_A,           &contexto->A, supervisor);
+  mmu_le(self->mmu, IRQ_END_X,           &contexto->X, supervisor);
+  mmu_le(self->mmu, IRQ_END_erro,        &erro, supervisor);
+  mmu_le(self->mmu, IRQ_END_complemento, &contexto->complemento, supervisor);
+  mmu_le(self->mmu, IRQ_END_modo,        &modo, supervisor);
+  contexto->erro = erro;
+  contexto->modo = modo;
+}
+
+void cpu_define_contexto(cpu_t *self, cpu_contexto_t *contexto)
+{
+  if (self->salvamento == cpu_salva_no_banco) {
+    self->banco = *contexto;
+    return;
+  }
+  mmu_escreve(self->mmu, IRQ_END_PC,          contexto->PC, supervisor);
+  mmu_escreve(self->mmu, IRQ_END_A,           contexto->A, supervisor);
+  mmu_escreve(self->mmu, IRQ_END_X,           contexto->X, supervisor);
+  mmu_escreve(self->mmu, IRQ_END_erro,        contexto->erro, supervisor);
+  mmu_escreve(self->mmu, IRQ_END_complemento, contexto->complemento, supervisor);
+  mmu_escreve(self->mmu, IRQ_END_modo,        contexto->modo, supervisor);
+}
+
 // vim: foldmethod=marker
@@ -19,6 +19,26 @@ typedef enum { supervisor, usuario } cpu_modo_t;
 // tipo da função a ser chamada quando executar a instrução CHAMAC
 typedef int (*func_chamaC_t)(void *argC, int reg_A);
 
+// estado da CPU salvo quando uma interrupção é aceita, e recuperado pela
+//   instrução RETI
+typedef struct {
+  int PC;
+  int A;
+  int X;
+  err_t erro;
+  int complemento;
+  cpu_modo_t modo;
+} cpu_contexto_t;
+
+// onde a CPU salva o estado numa interrupção
+typedef enum {
+  // no início da memória, nos endereços IRQ_END_* (ver irq.h)
+  cpu_salva_na_memoria,
+  // num banco de registradores interno da CPU, sem acessar a memória;
+  //   o SO acessa esse banco com cpu_le_contexto e cpu_define_contexto
+  cpu_salva_no_banco,
+} cpu_salvamento_t;
+
 
 // cria uma unidade de execução com acesso à MMU e ao
 //   controlador de E/S fornecidos
@@ -40,6 +60,16 @@ void cpu_executa_1(cpu_t *self);
 // retorna true se interrupção foi aceita ou false caso contrário
 bool cpu_interrompe(cpu_t *self, irq_t irq);
 
+// define onde o estado da CPU é salvo nas interrupções (inicialmente, na memória)
+void cpu_define_salvamento(cpu_t *self, cpu_salvamento_t salvamento);
+
+// copia para *contexto o estado salvo na última interrupção
+// funciona nos dois modos de salvamento, mas só é barato salvando no banco
+void cpu_le_contexto(cpu_t *self, cpu_contexto_t *contexto);
+
+// altera o estado que será recuperado pela próxima instrução RETI
+void cpu_define_contexto(cpu_t *self, cpu_contexto_t *contexto);
+
 // define a função a chamar quando executar a instrução CHAMAC
 // e o argumento a passar para ela (normalmente, um ponteiro para o SO)
 void cpu_define_chamaC(cpu_t *self, func_chamaC_t func, void *argC);
@@ -27,6 +27,27 @@ typedef enum {
   D_RELOGIO_REAL          = 17,
   D_RELOGIO_TIMER         = 18,
   D_RELOGIO_INTERRUPCAO   = 19,
+  D_RELOGIO_QUAL_TIMER    = 20,
+  D_RELOGIO_TIMER_0       = 21,
+  D_RELOGIO_PERIODO_0     = 22,
+  D_RELOGIO_INTERRUPCAO_0 = 23,
+  D_RELOGIO_TIMER_1       = 24,
+  D_RELOGIO_PERIODO_1     = 25,
+  D_RELOGIO_INTERRUPCAO_1 = 26,
+  D_RELOGIO_TIMER_2       = 27,
+  D_RELOGIO_PERIODO_2     = 28,
+  D_RELOGIO_INTERRUPCAO_2 = 29,
+  D_RELOGIO_TIMER_3       = 30,
+  D_RELOGIO_PERIODO_3     = 31,
+  D_RELOGIO_INTERRUPCAO_3 = 32,
+  D_RELOGIO_REAL_SEG      = 33,
+  D_RELOGIO_REAL_NS       = 34,
+  D_PIC_PENDENTES         = 35,
+  D_PIC_MASCARA           = 36,
+  D_PIC_RECONHECE         = 37,
+  D_PIC_IRQ               = 38,
+  D_PIC_SELECIONA         = 39,
+  D_PIC_PRIORIDADE        = 40,
   N_DISPOSITIVOS
 } dispositivo_id_t;
 
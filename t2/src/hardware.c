@@ -0,0 +1,116 @@
+// hardware.c
+// criação e destruição dos componentes do computador simulado
+// simulador de computador
+// so24b
+
+#include "hardware.h"
+#include "terminal.h"
+#include "dispositivos.h"
+
+#include <stdlib.h>
+
+// constantes
+#define MEM_TAM 10000        // tamanho da memória principal
+
+// os dispositivos do relógio em dispositivos.h têm que acompanhar os ids
+//   dele, que dependem do número de timers
+_Static_assert(D_RELOGIO_TIMER_0 + 3 * RELOGIO_N_TIMERS == D_RELOGIO_REAL_SEG,
+               "dispositivos.h nao tem os registradores de todos os timers");
+_Static_assert(D_RELOGIO_REAL_SEG - D_RELOGIO_TIMER_0
+               == RELOGIO_ID_REAL_SEG - RELOGIO_ID_TIMERS
+               && D_RELOGIO_REAL_NS == D_RELOGIO_REAL_SEG + 1,
+               "ids de tempo real do relogio diferentes de dispositivos.h");
+
+void hardware_cria(hardware_t *hw)
+{
+  // cria a memória e a MMU
+  hw->mem = mem_cria(MEM_TAM);
+  hw->mem_secundaria = mem_cria(MEM_TAM * 10);
+  hw->mmu = mmu_cria(hw->mem);
+
+  // cria dispositivos de E/S
+  hw->console = console_cria();
+  hw->relogio = relogio_cria();
+  // o relógio e os terminais pedem interrupções ao controlador de interrupções
+  hw->pic = pic_cria();
+  relogio_define_pic(hw->relogio, hw->pic);
+  for (char t = 'A'; console_terminal(hw->console, t) != NULL; t++) {
+    terminal_define_pic(console_terminal(hw->console, t), hw->pic);
+  }
+
+  // cria o controlador de E/S e registra os dispositivos
+  //   por exemplo, o dispositivo 8 do controlador de E/S (e da CPU) será o
+  //   dispositivo 0 do relógio (que é o contador de instruções)
+  hw->es = es_cria();
+  // lê teclado, testa teclado, escreve tela, testa tela do terminal A
+  terminal_t *terminal;
+  terminal = console_terminal(hw->console, 'A');
+  es_registra_dispositivo(hw->es, D_TERM_A_TECLADO    , terminal, 0, terminal_leitura, NULL);
+  es_registra_dispositivo(hw->es, D_TERM_A_TECLADO_OK , terminal, 1, terminal_leitura, NULL);
+  es_registra_dispositivo(hw->es, D_TERM_A_TELA       , terminal, 2, NULL, terminal_escrita);
+  es_registra_dispositivo(hw->es, D_TERM_A_TELA_OK    , terminal, 3, terminal_leitura, NULL);
+  // lê teclado, testa teclado, escreve tela, testa tela do terminal B
+  terminal = console_terminal(hw->console, 'B');
+  es_registra_dispositivo(hw->es, D_TERM_B_TECLADO    , terminal, 0, terminal_leitura, NULL);
+  es_registra_dispositivo(hw->es, D_TERM_B_TECLADO_OK , terminal, 1, terminal_leitura, NULL);
+  es_registra_dispositivo(hw->es, D_TERM_B_TELA       , terminal, 2, NULL, terminal_escrita);
+  es_registra_dispositivo(hw->es, D_TERM_B_TELA_OK    , terminal, 3, terminal_leitura, NULL);
+  // lê teclado, testa teclado, escreve tela, testa tela do terminal C
+  terminal = console_terminal(hw->console, 'C');
+  es_registra_dispositivo(hw->es, D_TERM_C_TECLADO    , terminal, 0, terminal_leitura, NULL);
+  es_registra_dispositivo(hw->es, D_TERM_C_TECLADO_OK , terminal, 1, terminal_leitura, NULL);
+  es_registra_dispositivo(hw->es, D_TERM_C_TELA       , terminal, 2, NULL, terminal_escrita);
+  es_registra_dispositivo(hw->es, D_TERM_C_TELA_OK    , terminal, 3, terminal_leitura, NULL);
+  // lê teclado, testa teclado, escreve tela, testa tela do terminal D
+  terminal = console_terminal(hw->console, 'D');
+  es_registra_dispositivo(hw->es, D_TERM_D_TECLADO    , terminal, 0, terminal_leitura, NULL);
+  es_registra_dispositivo(hw->es, D_TERM_D_TECLADO_OK , terminal, 1, terminal_leitura, NULL);
+  es_registra_dispositivo(hw->es, D_TERM_D_TELA       , terminal, 2, NULL, terminal_escrita);
+  es_registra_dispositivo(hw->es, D_TERM_D_TELA_OK    , terminal, 3, terminal_leitura, NULL);
+  // lê relógio virtual, relógio real
+  es_registra_dispositivo(hw->es, D_RELOGIO_INSTRUCOES, hw->relogio, 0, relogio_leitura, NULL);
+  es_registra_dispositivo(hw->es, D_RELOGIO_REAL      , hw->relogio, 1, relogio_leitura, NULL);
+  es_registra_dispositivo(hw->es, D_RELOGIO_REAL_SEG  , hw->relogio, RELOGIO_ID_REAL_SEG,
+                          relogio_leitura, NULL);
+  es_registra_dispositivo(hw->es, D_RELOGIO_REAL_NS   , hw->relogio, RELOGIO_ID_REAL_NS,
+                          relogio_leitura, NULL);
+  es_registra_dispositivo(hw->es, D_RELOGIO_TIMER     , hw->relogio, 2, relogio_leitura, relogio_escrita);
+  es_registra_dispositivo(hw->es, D_RELOGIO_INTERRUPCAO,hw->relogio, 3, relogio_leitura, relogio_escrita);
+  // qual timer está pedindo interrupção, e contador, período e pedido de
+  //   interrupção de cada timer (ver relogio.h)
+  es_registra_dispositivo(hw->es, D_RELOGIO_QUAL_TIMER, hw->relogio, 4, relogio_leitura, relogio_escrita);
+  for (int t = 0; t < RELOGIO_N_TIMERS; t++) {
+    for (int i = 0; i < 3; i++) {
+      es_registra_dispositivo(hw->es, D_RELOGIO_TIMER_0 + 3 * t + i, hw->relogio,
+                              RELOGIO_ID_TIMERS + 3 * t + i, relogio_leitura, relogio_escrita);
+    }
+  }
+  // pendências, máscara, reconhecimento, próxima irq, e prioridade de cada
+  //   linha (selecionada por D_PIC_SELECIONA) do controlador de interrupções
+  es_registra_dispositivo(hw->es, D_PIC_PENDENTES     , hw->pic, 0, pic_leitura, NULL);
+  es_registra_dispositivo(hw->es, D_PIC_MASCARA       , hw->pic, 1, pic_leitura, pic_escrita);
+  es_registra_dispositivo(hw->es, D_PIC_RECONHECE     , hw->pic, 2, NULL, pic_escrita);
+  es_registra_dispositivo(hw->es, D_PIC_IRQ           , hw->pic, 3, pic_leitura, NULL);
+  es_registra_dispositivo(hw->es, D_PIC_SELECIONA     , hw->pic, 4, pic_leitura, pic_escrita);
+  es_registra_dispositivo(hw->es, D_PIC_PRIORIDADE    , hw->pic, 5, pic_leitura, pic_escrita);
+
+  // cria a unidade de execução e inicializa com a MMU e E/S
+  hw->cpu = cpu_cria(hw->mmu, hw->es);
+
+  // cria o controlador da CPU e inicializa com a unidade de execução, a console,
+  //   o relógio e o controlador de interrupções
+  hw->controle = controle_cria(hw->cpu, hw->console, hw->relogio, hw->pic);
+}
+
+void hardware_destroi(hardware_t *hw)
+{
+  controle_destroi(hw->controle);
+  cpu_destroi(hw->cpu);
+  es_destroi(hw->es);
+  relogio_destroi(hw->relogio);
+  pic_destroi(hw->pic);
+  console_destroi(hw->console);
+  mmu_destroi(hw->mmu);
+  mem_destroi(hw->mem_secundaria);
+  mem_destroi(hw->mem);
+}
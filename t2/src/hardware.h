@@ -0,0 +1,37 @@
+// hardware.h
+// criação e destruição dos componentes do computador simulado
+// simulador de computador
+// so24b
+
+#ifndef HARDWARE_H
+#define HARDWARE_H
+
+#include "controle.h"
+#include "memoria.h"
+#include "mmu.h"
+#include "cpu.h"
+#include "relogio.h"
+#include "pic.h"
+#include "console.h"
+#include "es.h"
+
+// estrutura com os componentes do computador simulado
+typedef struct {
+  mem_t *mem;
+  mem_t* mem_secundaria;
+  mmu_t *mmu;
+  cpu_t *cpu;
+  relogio_t *relogio;
+  pic_t *pic;
+  console_t *console;
+  es_t *es;
+  controle_t *controle;
+} hardware_t;
+
+// cria todos os componentes e registra os dispositivos de E/S
+void hardware_cria(hardware_t *hw);
+
+// destrói todos os componentes
+void hardware_destroi(hardware_t *hw);
+
+#endif // HARDWARE_H
@@ -0,0 +1,127 @@
+#include "heap.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+#define HEAP_INITIAL_CAPACITY 8
+
+typedef struct {
+    void* item;
+    unsigned int seq; // Ordem de chegada, para desempate.
+} Heap_Node;
+
+struct heap {
+    Heap_Node* nodes;
+    int capacity;
+    int size;
+    unsigned int next_seq;
+    HeapKey key;
+    HeapIndex index;
+};
+
+Heap* heap_create(HeapKey key, HeapIndex index) {
+    Heap* heap = malloc(sizeof(Heap));
+    assert(heap);
+
+    *heap = (Heap) {
+        .nodes = malloc(sizeof(Heap_Node) * HEAP_INITIAL_CAPACITY),
+        .capacity = HEAP_INITIAL_CAPACITY,
+        .size = 0,
+        .next_seq = 0,
+        .key = key,
+        .index = index,
+    };
+    assert(heap->nodes);
+
+    return heap;
+}
+
+void heap_destroy(Heap* heap) {
+    for (int i = 0; i < heap->size; i++) *heap->index(heap->nodes[i].item) = -1;
+    free(heap->nodes);
+    free(heap);
+}
+
+int heap_size(Heap* heap) {
+    return heap->size;
+}
+
+static bool heap_less(Heap* heap, int i, int j) {
+    Heap_Node* a = &heap->nodes[i];
+    Heap_Node* b = &heap->nodes[j];
+    double key_a = heap->key(a->item);
+    double key_b = heap->key(b->item);
+    if (key_a != key_b) return key_a < key_b;
+    return a->seq < b->seq;
+}
+
+static void heap_swap(Heap* heap, int i, int j) {
+    Heap_Node tmp = heap->nodes[i];
+    heap->nodes[i] = heap->nodes[j];
+    heap->nodes[j] = tmp;
+    *heap->index(heap->nodes[i].item) = i;
+    *heap->index(heap->nodes[j].item) = j;
+}
+
+static void heap_sift_up(Heap* heap, int i) {
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!heap_less(heap, i, parent)) break;
+        heap_swap(heap, i, parent);
+        i = parent;
+    }
+}
+
+static void heap_sift_down(Heap* heap, int i) {
+    for (;;) {
+        int smallest = i;
+        int left = 2 * i + 1;
+        int right = left + 1;
+        if (left < heap->size && heap_less(heap, left, smallest)) smallest = left;
+        if (right < heap->size && heap_less(heap, right, smallest)) smallest = right;
+        if (smallest == i) break;
+        heap_swap(heap, i, smallest);
+        i = smallest;
+    }
+}
+
+void heap_push(Heap* heap, void* item) {
+    assert(*heap->index(item) < 0);
+
+    if (heap->size == heap->capacity) {
+        heap->capacity *= 2;
+        heap->nodes = realloc(heap->nodes, sizeof(Heap_Node) * heap->capacity);
+        assert(heap->nodes);
+    }
+
+    int i = heap->size++;
+    heap->nodes[i] = (Heap_Node) { .item = item, .seq = heap->next_seq++ };
+    *heap->index(item) = i;
+    heap_sift_up(heap, i);
+}
+
+void* heap_peek(Heap* heap) {
+    if (heap->size == 0) return NULL;
+    return heap->nodes[0].item;
+}
+
+void heap_remove(Heap* heap, void* item) {
+    int i = *heap->index(item);
+    if (i < 0) return;
+    assert(i < heap->size && heap->nodes[i].item == item);
+
+    int last = --heap->size;
+    if (i != last) {
+        heap->nodes[i] = heap->nodes[last];
+        *heap->index(heap->nodes[i].item) = i;
+        heap_sift_down(heap, i);
+        heap_sift_up(heap, i);
+    }
+    *heap->index(item) = -1;
+}
+
+void* heap_pop(Heap* heap) {
+    void* item = heap_peek(heap);
+    if (item != NULL) heap_remove(heap, item);
+    return item;
+}
@@ -0,0 +1,34 @@
+#ifndef HEAP_H
+#define HEAP_H
+
+#include <stdbool.h>
+
+// Heap mínimo indexado, usado pelas filas de processos ordenadas (ver
+//   prio_queue.h e timer_queue.h).
+// Os itens são ordenados pela chave dada por 'key'; empates saem na ordem de
+//   chegada. Cada item guarda sua posição no heap no inteiro apontado por
+//   'index' (-1 se não está nele), o que permite remover um item qualquer em
+//   O(log n).
+// A chave de um item não pode mudar enquanto ele estiver no heap.
+typedef double (*HeapKey)(void* item);
+typedef int* (*HeapIndex)(void* item);
+
+typedef struct heap Heap;
+
+Heap* heap_create(HeapKey key, HeapIndex index);
+
+// Os itens que ainda estão no heap ficam com a posição -1.
+void heap_destroy(Heap* heap);
+
+int heap_size(Heap* heap);
+
+void heap_push(Heap* heap, void* item);
+
+// Retorna NULL se o heap estiver vazio.
+void* heap_peek(Heap* heap);
+void* heap_pop(Heap* heap);
+
+// Não faz nada se o item não estiver no heap.
+void heap_remove(Heap* heap, void* item);
+
+#endif // HEAP_H
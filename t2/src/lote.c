@@ -0,0 +1,112 @@
+// lote.c
+// executa a simulação sem tela, com entrada e saída em arquivos
+// simulador de computador
+// so24b
+
+// a simulação executa sem curses (ligada com tela_nula.c) até não existirem
+//   mais processos, sem esperar o operador, e pode ser usada em scripts
+// uso: lote [-i programa] [-s script] [-e T arquivo]... [-t T arquivo]...
+//            [escalonador]
+//   -i: o processo inicial executa o programa (sem -i, init.maq)
+//   -s: os comandos do operador vêm do arquivo (sem script, só 'C')
+//   -e: o que for escrito no arquivo (pode ser um fifo) é digitado no terminal T
+//   -t: a saída do terminal T é copiada para o arquivo
+// as mensagens da console vão para o arquivo log_da_console
+
+#include "hardware.h"
+#include "scheduler.h"
+#include "so.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// política de escalonamento usada se não for escolhida na linha de comando
+#define ESCALONADOR_PADRAO "rr"
+
+static bool terminou(void *arg)
+{
+  return so_terminou(arg);
+}
+
+static void uso(char *nome)
+{
+  fprintf(stderr, "uso: %s [-i programa] [-s script] [-e T arquivo]... "
+                  "[-t T arquivo]... [escalonador]\nescalonadores:", nome);
+  for (int i = 0; scheduler_policy_name(i) != NULL; i++) {
+    fprintf(stderr, " %s", scheduler_policy_name(i));
+  }
+  fprintf(stderr, "\n");
+  exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+  hardware_t hw;
+  so_t *so;
+
+  // cria o hardware
+  hardware_cria(&hw);
+  // ninguém está olhando: os terminais não perdem tempo com animação
+  for (char t = 'A'; console_terminal(hw.console, t) != NULL; t++) {
+    terminal_define_modo(console_terminal(hw.console, t), terminal_instantaneo);
+  }
+
+  char *escalonador = ESCALONADOR_PADRAO;
+  char *programa = NULL;
+  bool tem_script = false;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-i") == 0 && i + 1 < argc) {
+      programa = argv[++i];
+    } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+      if (!console_define_script(hw.console, argv[++i])) {
+        fprintf(stderr, "não consegui abrir o script '%s'\n", argv[i]);
+        uso(argv[0]);
+      }
+      tem_script = true;
+    } else if (strcmp(argv[i], "-e") == 0 && i + 2 < argc) {
+      if (!console_entrada_do_terminal(hw.console, argv[i+1][0], argv[i+2])) {
+        fprintf(stderr, "não consegui ligar '%s' ao terminal '%s'\n", argv[i+2], argv[i+1]);
+        uso(argv[0]);
+      }
+      i += 2;
+    } else if (strcmp(argv[i], "-t") == 0 && i + 2 < argc) {
+      if (!console_saida_do_terminal(hw.console, argv[i+1][0], argv[i+2])) {
+        fprintf(stderr, "não consegui ligar o terminal '%s' a '%s'\n", argv[i+1], argv[i+2]);
+        uso(argv[0]);
+      }
+      i += 2;
+    } else if (argv[i][0] == '-' || i != argc - 1) {
+      uso(argv[0]);
+    } else {
+      escalonador = argv[i];
+    }
+  }
+
+  // cria o sistema operacional
+  so = so_cria(hw.cpu, hw.mem, hw.mem_secundaria, hw.mmu, hw.es, hw.console,
+               escalonador);
+  if (so == NULL) {
+    fprintf(stderr, "escalonador '%s' não existe\n", escalonador);
+    hardware_destroi(&hw);
+    uso(argv[0]);
+  }
+  if (programa != NULL) so_define_programa_inicial(so, programa);
+
+  // a simulação acaba quando o SO não tiver mais processos (ou com 'F')
+  controle_define_fim(hw.controle, terminou, so);
+  if (!tem_script) console_comando(hw.console, "C");
+  controle_laco(hw.controle);
+
+  // mostra a contabilidade dos processos no final (vai para o log)
+  so_imprime_relatorio(so);
+  long perdidas = console_mensagens_perdidas(hw.console);
+  if (perdidas > 0) {
+    fprintf(stderr, "%ld mensagens da console não foram para o log_da_console\n", perdidas);
+  }
+
+  // destroi tudo
+  so_destroi(so);
+  hardware_destroi(&hw);
+  return 0;
+}
@@ -0,0 +1,94 @@
+#include "mlfq.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+typedef struct {
+    Process* first;
+    Process* last;
+} Mlfq_Level;
+
+struct mlfq {
+    Mlfq_Level* levels;
+    int n_levels;
+};
+
+Mlfq* mlfq_create(int levels) {
+    assert(levels > 0);
+    Mlfq* queue = malloc(sizeof(Mlfq));
+    assert(queue);
+
+    *queue = (Mlfq) {
+        .levels = calloc(levels, sizeof(Mlfq_Level)),
+        .n_levels = levels,
+    };
+    assert(queue->levels);
+
+    return queue;
+}
+
+void mlfq_destroy(Mlfq* queue) {
+    for (int l = 0; l < queue->n_levels; l++) {
+        while (queue->levels[l].first) mlfq_remove(queue, queue->levels[l].first);
+    }
+    free(queue->levels);
+    free(queue);
+}
+
+int mlfq_levels(Mlfq* queue) {
+    return queue->n_levels;
+}
+
+void mlfq_push(Mlfq* queue, Process* proc) {
+    assert(!proc->mlfq_queued);
+    assert(proc->mlfq_level >= 0 && proc->mlfq_level < queue->n_levels);
+
+    Mlfq_Level* level = &queue->levels[proc->mlfq_level];
+    proc->mlfq_prev = level->last;
+    proc->mlfq_next = NULL;
+    if (level->last) level->last->mlfq_next = proc;
+    else level->first = proc;
+    level->last = proc;
+    proc->mlfq_queued = true;
+}
+
+void mlfq_remove(Mlfq* queue, Process* proc) {
+    if (!proc->mlfq_queued) return;
+
+    Mlfq_Level* level = &queue->levels[proc->mlfq_level];
+    if (proc->mlfq_prev) proc->mlfq_prev->mlfq_next = proc->mlfq_next;
+    else level->first = proc->mlfq_next;
+    if (proc->mlfq_next) proc->mlfq_next->mlfq_prev = proc->mlfq_prev;
+    else level->last = proc->mlfq_prev;
+
+    proc->mlfq_prev = NULL;
+    proc->mlfq_next = NULL;
+    proc->mlfq_queued = false;
+}
+
+Process* mlfq_pop(Mlfq* queue) {
+    for (int l = 0; l < queue->n_levels; l++) {
+        Process* proc = queue->levels[l].first;
+        if (proc) {
+            mlfq_remove(queue, proc);
+            return proc;
+        }
+    }
+    return NULL;
+}
+
+void mlfq_boost(Mlfq* queue) {
+    Mlfq_Level* top = &queue->levels[0];
+    for (int l = 1; l < queue->n_levels; l++) {
+        Mlfq_Level* level = &queue->levels[l];
+        if (!level->first) continue;
+
+        for (Process* proc = level->first; proc; proc = proc->mlfq_next) proc->mlfq_level = 0;
+        level->first->mlfq_prev = top->last;
+        if (top->last) top->last->mlfq_next = level->first;
+        else top->first = level->first;
+        top->last = level->last;
+        level->first = NULL;
+        level->last = NULL;
+    }
+}
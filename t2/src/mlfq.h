@@ -0,0 +1,32 @@
+#ifndef MLFQ_H
+#define MLFQ_H
+
+#include "process.h"
+
+// Filas de processos prontos em vários níveis (multilevel feedback queue).
+// Cada nível é uma lista duplamente encadeada usando os campos 'mlfq_prev' e
+//   'mlfq_next' do próprio processo, então inserir, retirar e remover são O(1).
+// O processo é inserido no nível indicado por 'mlfq_level'; o nível 0 é o de
+//   maior prioridade.
+typedef struct mlfq Mlfq;
+
+Mlfq* mlfq_create(int levels);
+
+void mlfq_destroy(Mlfq* queue);
+
+int mlfq_levels(Mlfq* queue);
+
+// Insere no final da fila do nível 'proc->mlfq_level'.
+void mlfq_push(Mlfq* queue, Process* proc);
+
+// Retira o primeiro processo do nível de maior prioridade que não está vazio.
+// Retorna NULL se todas as filas estiverem vazias.
+Process* mlfq_pop(Mlfq* queue);
+
+// Não faz nada se o processo não estiver em uma das filas.
+void mlfq_remove(Mlfq* queue, Process* proc);
+
+// Passa todos os processos das filas para o nível 0, mantendo a ordem.
+void mlfq_boost(Mlfq* queue);
+
+#endif // MLFQ_H
@@ -88,3 +88,45 @@ err_t mmu_escreve(mmu_t *self, int endvirt, int valor, cpu_modo_t modo)
   }
   return err;
 }
+
+// copia entre 'valores' e a memória, página a página; 'escrita' diz o sentido
+static int mmu__bloco(mmu_t *self, tabpag_t *tabpag, int endvirt, int n,
+                      int valores[], bool escrita)
+{
+  int feitos = 0;
+  while (feitos < n) {
+    int pagina = (endvirt + feitos) / TAM_PAGINA;
+    int deslocamento = (endvirt + feitos) % TAM_PAGINA;
+    int quadro;
+    if (endvirt + feitos < 0) break;
+    if (tabpag_traduz(tabpag, pagina, &quadro) != ERR_OK) break;
+    // quantos valores estão nesta página
+    int na_pagina = TAM_PAGINA - deslocamento;
+    if (na_pagina > n - feitos) na_pagina = n - feitos;
+    int endfis = quadro * TAM_PAGINA + deslocamento;
+    int i;
+    for (i = 0; i < na_pagina; i++) {
+      err_t err;
+      if (escrita) {
+        err = mem_escreve(self->mem, endfis + i, valores[feitos + i]);
+      } else {
+        err = mem_le(self->mem, endfis + i, &valores[feitos + i]);
+      }
+      if (err != ERR_OK) break;
+    }
+    if (i > 0) tabpag_marca_bit_acesso(tabpag, pagina, escrita);
+    feitos += i;
+    if (i < na_pagina) break;
+  }
+  return feitos;
+}
+
+int mmu_le_bloco(mmu_t *self, tabpag_t *tabpag, int endvirt, int n, int valores[])
+{
+  return mmu__bloco(self, tabpag, endvirt, n, valores, false);
+}
+
+int mmu_escreve_bloco(mmu_t *self, tabpag_t *tabpag, int endvirt, int n, int valores[])
+{
+  return mmu__bloco(self, tabpag, endvirt, n, valores, true);
+}
@@ -58,4 +58,15 @@ err_t mmu_le(mmu_t *self, int endvirt, int *pvalor, cpu_modo_t modo);
 //   à memória sem tradução
 err_t mmu_escreve(mmu_t *self, int endvirt, int valor, cpu_modo_t modo);
 
+// acesso em bloco à memória de um processo, para o SO copiar dados de e para
+//   processos sem que a tabela de páginas deles esteja na MMU
+// lê (ou escreve) até 'n' valores a partir do endereço virtual 'endvirt',
+//   traduzido pela tabela 'tabpag' (não pela definida com mmu_define_tabpag),
+//   com uma tradução por página e não por valor; marca as páginas acessadas
+//   (e alteradas) como mmu_le e mmu_escreve
+// para no primeiro endereço que não puder ser acessado
+// retorna o número de valores lidos (ou escritos)
+int mmu_le_bloco(mmu_t *self, tabpag_t *tabpag, int endvirt, int n, int valores[]);
+int mmu_escreve_bloco(mmu_t *self, tabpag_t *tabpag, int endvirt, int n, int valores[]);
+
 #endif // MMU_H
@@ -0,0 +1,69 @@
+// perfil.c
+// medição do tempo real gasto em partes do simulador
+// simulador de computador
+// so24b
+
+#include "perfil.h"
+
+#include <stdlib.h>
+#include <time.h>
+#include <assert.h>
+
+struct perfil_t {
+  int n_fases;
+  perfil_fase_t *fases;
+  // instante em que começou a execução corrente de cada fase
+  long long *inicio;
+};
+
+long long perfil_agora_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+perfil_t *perfil_cria(int n_fases, char *nomes[])
+{
+  perfil_t *self = malloc(sizeof(*self));
+  assert(self != NULL);
+  self->n_fases = n_fases;
+  self->fases = calloc(n_fases, sizeof(*self->fases));
+  self->inicio = calloc(n_fases, sizeof(*self->inicio));
+  assert(self->fases != NULL && self->inicio != NULL);
+  for (int f = 0; f < n_fases; f++) {
+    self->fases[f].nome = nomes[f];
+  }
+  return self;
+}
+
+void perfil_destroi(perfil_t *self)
+{
+  free(self->fases);
+  free(self->inicio);
+  free(self);
+}
+
+void perfil_inicia(perfil_t *self, int fase)
+{
+  self->inicio[fase] = perfil_agora_ns();
+}
+
+void perfil_termina(perfil_t *self, int fase)
+{
+  long long duracao = perfil_agora_ns() - self->inicio[fase];
+  perfil_fase_t *f = &self->fases[fase];
+  f->n++;
+  f->total_ns += duracao;
+  if (duracao > f->max_ns) f->max_ns = duracao;
+}
+
+int perfil_n_fases(perfil_t *self)
+{
+  return self->n_fases;
+}
+
+void perfil_fase(perfil_t *self, int fase, perfil_fase_t *dados)
+{
+  *dados = self->fases[fase];
+}
@@ -0,0 +1,45 @@
+// perfil.h
+// medição do tempo real gasto em partes do simulador
+// simulador de computador
+// so24b
+
+#ifndef PERFIL_H
+#define PERFIL_H
+
+// um perfil tem um número fixo de fases, identificadas por 0, 1, ...
+// para cada fase, são contados o número de vezes em que foi executada e o
+//   tempo real (do computador hospedeiro, não do simulado) gasto nela
+// as medições usam um relógio monotônico com resolução de nanossegundos
+
+typedef struct perfil_t perfil_t;
+
+// dados acumulados de uma fase
+typedef struct {
+  char *nome;
+  long n;              // número de execuções da fase
+  long long total_ns;  // tempo somado de todas as execuções
+  long long max_ns;    // tempo da execução mais demorada
+} perfil_fase_t;
+
+// retorna o tempo real monotônico atual, em ns (a partir de um instante
+//   qualquer, só serve para medir intervalos)
+long long perfil_agora_ns(void);
+
+// cria um perfil com n_fases fases, com os nomes em 'nomes' (os nomes não
+//   são copiados)
+perfil_t *perfil_cria(int n_fases, char *nomes[]);
+
+// destrói um perfil
+void perfil_destroi(perfil_t *self);
+
+// marca o início e o fim de uma execução da fase
+void perfil_inicia(perfil_t *self, int fase);
+void perfil_termina(perfil_t *self, int fase);
+
+// retorna o número de fases do perfil
+int perfil_n_fases(perfil_t *self);
+
+// coloca em 'dados' o que foi medido na fase
+void perfil_fase(perfil_t *self, int fase, perfil_fase_t *dados);
+
+#endif // PERFIL_H
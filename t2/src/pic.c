@@ -0,0 +1,116 @@
+// pic.c
+// controlador de interrupções
+// simulador de computador
+// so24b
+
+#include "pic.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <assert.h>
+
+struct pic_t {
+  // bit i ligado se a linha i está pendente / habilitada
+  unsigned pendentes;
+  unsigned mascara;
+  // prioridade de cada linha (menor é mais prioritária)
+  int prioridade[N_IRQ];
+  // linha selecionada para acesso à prioridade
+  int selecionada;
+};
+
+pic_t *pic_cria(void)
+{
+  pic_t *self = malloc(sizeof(*self));
+  assert(self != NULL);
+
+  self->pendentes = 0;
+  self->mascara = 0;
+  for (int irq = 0; irq < N_IRQ; irq++) {
+    self->prioridade[irq] = irq;
+  }
+  self->selecionada = 0;
+
+  return self;
+}
+
+void pic_destroi(pic_t *self)
+{
+  free(self);
+}
+
+void pic_pede(pic_t *self, irq_t irq)
+{
+  self->pendentes |= 1u << irq;
+}
+
+int pic_irq(pic_t *self)
+{
+  unsigned ativas = self->pendentes & self->mascara;
+  if (ativas == 0) return -1;
+
+  int escolhida = -1;
+  for (int irq = 0; irq < N_IRQ; irq++) {
+    if ((ativas & (1u << irq)) == 0) continue;
+    if (escolhida < 0 || self->prioridade[irq] < self->prioridade[escolhida]) {
+      escolhida = irq;
+    }
+  }
+  return escolhida;
+}
+
+static bool linha_valida(int irq)
+{
+  return irq >= 0 && irq < N_IRQ;
+}
+
+err_t pic_leitura(void *disp, int id, int *pvalor)
+{
+  pic_t *self = disp;
+  err_t err = ERR_OK;
+  switch (id) {
+    case 0:
+      *pvalor = self->pendentes;
+      break;
+    case 1:
+      *pvalor = self->mascara;
+      break;
+    case 3:
+      *pvalor = pic_irq(self);
+      break;
+    case 4:
+      *pvalor = self->selecionada;
+      break;
+    case 5:
+      *pvalor = self->prioridade[self->selecionada];
+      break;
+    default:
+      err = ERR_END_INV;
+  }
+  return err;
+}
+
+err_t pic_escrita(void *disp, int id, int valor)
+{
+  pic_t *self = disp;
+  err_t err = ERR_OK;
+  switch (id) {
+    case 1:
+      self->mascara = valor & ((1u << N_IRQ) - 1);
+      break;
+    case 2:
+      if (!linha_valida(valor)) return ERR_OP_INV;
+      self->pendentes &= ~(1u << valor);
+      break;
+    case 4:
+      if (!linha_valida(valor)) return ERR_OP_INV;
+      self->selecionada = valor;
+      break;
+    case 5:
+      self->prioridade[self->selecionada] = valor;
+      break;
+    default:
+      err = ERR_END_INV;
+  }
+  return err;
+}
@@ -0,0 +1,53 @@
+// pic.h
+// controlador de interrupções
+// simulador de computador
+// so24b
+
+#ifndef PIC_H
+#define PIC_H
+
+// simulador do controlador de interrupções
+// cada requisição de interrupção (irq, ver irq.h) é uma linha do controlador;
+//   os dispositivos pedem interrupção ligando o bit da linha no registrador
+//   de pendências, que só é desligado quando o SO reconhece a interrupção
+// uma linha só é entregue à CPU se estiver habilitada na máscara; das linhas
+//   pendentes e habilitadas, é entregue a de maior prioridade (menor valor;
+//   em caso de empate, a de menor número)
+// inicialmente todas as linhas estão desabilitadas, e a prioridade de cada
+//   linha é o seu número
+
+#include "err.h"
+#include "irq.h"
+
+typedef struct pic_t pic_t;
+
+// cria e inicializa um controlador de interrupções
+pic_t *pic_cria(void);
+
+// destrói um controlador de interrupções
+// nenhuma outra operação pode ser realizada no controlador após esta chamada
+void pic_destroi(pic_t *self);
+
+// um dispositivo pede uma interrupção na linha 'irq'
+void pic_pede(pic_t *self, irq_t irq);
+
+// retorna a linha pendente e habilitada de maior prioridade, -1 se nenhuma
+// esta função é chamada pelo controlador da CPU após cada instrução; quando
+//   não tem nada pendente, só testa um valor
+int pic_irq(pic_t *self);
+
+// Funções para acessar o controlador como dispositivo de E/S, com id:
+//   '0' para ler o registrador de pendências (o bit 'irq' é 1 se a linha
+//       'irq' está pendente)
+//   '1' para ler ou escrever a máscara (o bit 'irq' é 1 se a linha está
+//       habilitada)
+//   '2' para escrever o número de uma linha, reconhecendo a interrupção dela
+//       (desliga o bit no registrador de pendências)
+//   '3' para ler a linha que seria entregue à CPU (-1 se nenhuma)
+//   '4' para ler ou escrever a linha selecionada para o registrador '5'
+//   '5' para ler ou escrever a prioridade da linha selecionada
+// Devem seguir o protocolo f_leitura_t e f_escrita_t declarados em es.h
+err_t pic_leitura(void *disp, int id, int *pvalor);
+err_t pic_escrita(void *disp, int id, int valor);
+
+#endif // PIC_H
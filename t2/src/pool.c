@@ -0,0 +1,81 @@
+#include "pool.h"
+
+#include <stdlib.h>
+#include <assert.h>
+
+// Um objeto livre guarda o ponteiro para o próximo livre.
+typedef struct free_object {
+    struct free_object* next;
+} Free_Object;
+
+// Cabeçalho de cada bloco; os objetos vêm logo depois.
+typedef struct slab {
+    struct slab* next;
+} Slab;
+
+struct pool {
+    size_t object_size;
+    int objects_per_slab;
+    Free_Object* free_list;
+    Slab* slabs;
+};
+
+Pool* pool_create(size_t object_size, int objects_per_slab) {
+    assert(objects_per_slab > 0);
+
+    Pool* pool = malloc(sizeof(Pool));
+    assert(pool);
+
+    // Cada objeto tem que caber um Free_Object e manter o alinhamento.
+    size_t align = sizeof(void*) > sizeof(double) ? sizeof(void*) : sizeof(double);
+    if (object_size < sizeof(Free_Object)) object_size = sizeof(Free_Object);
+    object_size = (object_size + align - 1) / align * align;
+
+    *pool = (Pool) {
+        .object_size = object_size,
+        .objects_per_slab = objects_per_slab,
+    };
+
+    return pool;
+}
+
+void pool_destroy(Pool* pool) {
+    while (pool->slabs) {
+        Slab* next = pool->slabs->next;
+        free(pool->slabs);
+        pool->slabs = next;
+    }
+    free(pool);
+}
+
+static void pool_grow(Pool* pool) {
+    size_t header = (sizeof(Slab) + pool->object_size - 1) / pool->object_size * pool->object_size;
+    Slab* slab = malloc(header + pool->object_size * pool->objects_per_slab);
+    assert(slab);
+
+    slab->next = pool->slabs;
+    pool->slabs = slab;
+
+    char* objects = (char*) slab + header;
+    for (int i = pool->objects_per_slab - 1; i >= 0; i--) {
+        Free_Object* object = (Free_Object*) (objects + i * pool->object_size);
+        object->next = pool->free_list;
+        pool->free_list = object;
+    }
+}
+
+void* pool_alloc(Pool* pool) {
+    if (pool->free_list == NULL) pool_grow(pool);
+
+    Free_Object* object = pool->free_list;
+    pool->free_list = object->next;
+    return object;
+}
+
+void pool_free(Pool* pool, void* object) {
+    if (object == NULL) return;
+
+    Free_Object* free_object = object;
+    free_object->next = pool->free_list;
+    pool->free_list = free_object;
+}
@@ -0,0 +1,26 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <stddef.h>
+
+// Alocador de objetos do SO de tamanho fixo (descritores de processo,
+//   tabelas de páginas, etc).
+// Os objetos são tirados de blocos ("slabs") com vários objetos, alocados
+//   com malloc só quando a lista de livres está vazia; um objeto liberado
+//   volta para a lista de livres do seu pool e é reaproveitado pela próxima
+//   alocação. A memória dos blocos só é devolvida em pool_destroy.
+typedef struct pool Pool;
+
+// 'objects_per_slab' é quantos objetos são alocados de cada vez.
+Pool* pool_create(size_t object_size, int objects_per_slab);
+
+// Libera todos os blocos, inclusive os objetos ainda em uso.
+void pool_destroy(Pool* pool);
+
+// O conteúdo do objeto retornado é indefinido.
+void* pool_alloc(Pool* pool);
+
+// 'object' deve ter sido alocado por este pool; NULL é ignorado.
+void pool_free(Pool* pool, void* object);
+
+#endif // POOL_H
@@ -0,0 +1,46 @@
+#include "prio_queue.h"
+#include "heap.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+// A fila é um heap indexado sobre 'priority', com a posição em 'ready_index'.
+struct prio_queue {
+    Heap* heap;
+};
+
+static double prio_queue_key(void* item) {
+    return ((Process*) item)->priority;
+}
+
+static int* prio_queue_index(void* item) {
+    return &((Process*) item)->ready_index;
+}
+
+PrioQueue* prio_queue_create(void) {
+    PrioQueue* queue = malloc(sizeof(PrioQueue));
+    assert(queue);
+    queue->heap = heap_create(prio_queue_key, prio_queue_index);
+    return queue;
+}
+
+void prio_queue_destroy(PrioQueue* queue) {
+    heap_destroy(queue->heap);
+    free(queue);
+}
+
+int prio_queue_size(PrioQueue* queue) {
+    return heap_size(queue->heap);
+}
+
+void prio_queue_push(PrioQueue* queue, Process* proc) {
+    heap_push(queue->heap, proc);
+}
+
+void prio_queue_remove(PrioQueue* queue, Process* proc) {
+    heap_remove(queue->heap, proc);
+}
+
+Process* prio_queue_pop(PrioQueue* queue) {
+    return heap_pop(queue->heap);
+}
@@ -0,0 +1,27 @@
+#ifndef PRIO_QUEUE_H
+#define PRIO_QUEUE_H
+
+#include "process.h"
+
+// Fila de processos prontos ordenada por prioridade (heap mínimo, ver heap.h).
+// O processo com menor valor de 'priority' sai primeiro; empates saem na
+//   ordem de chegada.
+// Cada processo guarda sua posição no heap ('ready_index'), o que permite
+//   remover um processo qualquer da fila em O(log n).
+typedef struct prio_queue PrioQueue;
+
+PrioQueue* prio_queue_create(void);
+
+void prio_queue_destroy(PrioQueue* queue);
+
+int prio_queue_size(PrioQueue* queue);
+
+void prio_queue_push(PrioQueue* queue, Process* proc);
+
+// Retorna NULL se a fila estiver vazia.
+Process* prio_queue_pop(PrioQueue* queue);
+
+// Não faz nada se o processo não estiver na fila.
+void prio_queue_remove(PrioQueue* queue, Process* proc);
+
+#endif // PRIO_QUEUE_H
@@ -1,13 +1,21 @@
 #include "process.h"
 
+#include "pool.h"
+
 #include <stdlib.h>
 #include <assert.h>
 
+#define PROCESS_POOL_SLAB 16
+
 int process_counter = 0;
 
-Process* process_create(dispositivo_id_t in, dispositivo_id_t out) {
-    Process* ps = malloc(sizeof(Process));
-    assert(ps);
+// Descritores de processo liberados são reaproveitados (ver pool.h); o pool
+//   é criado na primeira criação de processo e dura até process_destroy_pool.
+static Pool* process_pool = NULL;
+
+Process* process_create(dispositivo_id_t in, dispositivo_id_t out, int now) {
+    if (process_pool == NULL) process_pool = pool_create(sizeof(Process), PROCESS_POOL_SLAB);
+    Process* ps = pool_alloc(process_pool);
 
     *ps = (Process) {
         .pid = process_counter++,
@@ -16,6 +24,14 @@ Process* process_create(dispositivo_id_t in, dispositivo_id_t out) {
         .in = in,
         .out = out,
         .page_table = tabpag_cria(),
+        .stats = {
+            .creation_time = now,
+            .first_run_time = -1,
+            .termination_time = -1,
+            .state_since = now,
+        },
+        .ready_index = -1,
+        .timer_index = -1,
     };
 
     return ps;
@@ -23,5 +39,61 @@ Process* process_create(dispositivo_id_t in, dispositivo_id_t out) {
 
 void process_destroy(Process* proc) {
     tabpag_destroi(proc->page_table);
-    free(proc);
+    if (proc->output) queue_destroy(proc->output);
+    pool_free(process_pool, proc);
+}
+
+void process_destroy_pool(void) {
+    if (process_pool) pool_destroy(process_pool);
+    process_pool = NULL;
+}
+
+void process_set_state(Process* proc, Process_State state, int now) {
+    Process_Stats* stats = &proc->stats;
+    int elapsed = now - stats->state_since;
+
+    switch (proc->state) {
+        case Process_State_READY: stats->ready_time += elapsed; break;
+        case Process_State_RUNNING: stats->running_time += elapsed; break;
+        case Process_State_BLOCKING: stats->blocked_time += elapsed; break;
+        default: break;
+    }
+
+    if (state == Process_State_RUNNING && proc->state != Process_State_RUNNING) {
+        stats->dispatches++;
+        if (stats->first_run_time < 0) stats->first_run_time = now;
+    }
+    if (state == Process_State_TERMINATED && stats->termination_time < 0) {
+        stats->termination_time = now;
+    }
+
+    proc->state = state;
+    stats->state_since = now;
+}
+
+int process_blocking_index(Process_Blocking_On on) {
+    assert(on != Process_Blocking_On_NOT_BLOCKING);
+    int i = 0;
+    while ((on & 1) == 0) {
+        on >>= 1;
+        i++;
+    }
+    assert(i < PROCESS_BLOCKING_REASONS);
+    return i;
+}
+
+char* process_blocking_name(int i) {
+    // Na ordem dos bits de Process_Blocking_On.
+    static char* names[PROCESS_BLOCKING_REASONS] = {
+        "ent", "proc", "buf", "linha",
+        "pcheio", "pvazio", "sem", "futex", "dorme",
+    };
+    return names[i];
+}
+
+void process_block(Process* proc, Process_Blocking_On on, int id, int now) {
+    proc->stats.blocks[process_blocking_index(on)]++;
+
+    proc->blocking = (Process_Blocking) { .on = on, .id = id };
+    process_set_state(proc, Process_State_BLOCKING, now);
 }
@@ -4,6 +4,9 @@
 #include "err.h"
 #include "dispositivos.h"
 #include "tabpag.h"
+#include "queue.h"
+
+#include <stdbool.h>
 
 typedef enum {
     Process_State_NEW = 0,
@@ -16,10 +19,25 @@ typedef enum {
 typedef enum {
     Process_Blocking_On_NOT_BLOCKING = 0,
     Process_Blocking_On_INPUT = 1 << 0,
-    Process_Blocking_On_OUTPUT = 1 << 1,
-    Process_Blocking_On_PROCESS = 1 << 2,
+    Process_Blocking_On_PROCESS = 1 << 1,
+    // Buffer de saída do processo cheio ('id' é a chamada de sistema).
+    Process_Blocking_On_OUTPUT_BUFFER = 1 << 2,
+    // Esperando uma linha completa no buffer de entrada do terminal.
+    Process_Blocking_On_INPUT_LINE = 1 << 3,
+    // Pipe cheio ou vazio ('id' é o pipe).
+    Process_Blocking_On_PIPE_FULL = 1 << 4,
+    Process_Blocking_On_PIPE_EMPTY = 1 << 5,
+    // Na fila de espera de um semáforo ('id' é o semáforo) ou de um futex
+    //   ('id' é o endereço físico).
+    Process_Blocking_On_SEMAPHORE = 1 << 6,
+    Process_Blocking_On_FUTEX = 1 << 7,
+    // Dormindo até o instante 'wake_time' (SO_DORME).
+    Process_Blocking_On_SLEEP = 1 << 8,
 } Process_Blocking_On;
 
+// Número de motivos de bloqueio (bits de Process_Blocking_On).
+#define PROCESS_BLOCKING_REASONS 9
+
 typedef struct {
     Process_Blocking_On on;
     int id; // IO device or external process identififer.
@@ -32,7 +50,27 @@ typedef struct {
     err_t err;
 } Process_Context;
 
+// Contabilidade do processo.
+// Os instantes são em instruções executadas (D_RELOGIO_INSTRUCOES), -1 se
+//   ainda não aconteceram; os tempos são somas de intervalos nessa unidade.
 typedef struct {
+    int creation_time;
+    int first_run_time;
+    int termination_time;
+    // Instante da última mudança de estado.
+    int state_since;
+    int ready_time;
+    int running_time;
+    int blocked_time;
+    // Vezes em que foi escolhido pelo escalonador.
+    int dispatches;
+    // Vezes em que perdeu a CPU por fim de quantum.
+    int preemptions;
+    // Vezes em que bloqueou, por motivo (índice de process_blocking_index).
+    int blocks[PROCESS_BLOCKING_REASONS];
+} Process_Stats;
+
+typedef struct process {
     int pid;
     float priority;
     Process_State state;
@@ -42,9 +80,52 @@ typedef struct {
     dispositivo_id_t out;
     // T2:
     tabpag_t* page_table;
+    // Saída ainda não enviada ao terminal (NULL até a primeira escrita
+    //   bufferizada).
+    Queue* output;
+    // Valores já enviados na chamada SO_ENVIA em andamento.
+    int transferred;
+    Process_Stats stats;
+    // Posição na fila de prontos do escalonador por prioridade (-1 se não está nela).
+    int ready_index;
+    // Instante de acordar e posição na fila de processos dormindo (-1 se não
+    //   está nela).
+    int wake_time;
+    int timer_index;
+    // Nível e encadeamento nas filas do escalonador multinível.
+    int mlfq_level;
+    int mlfq_epoch;
+    bool mlfq_queued;
+    struct process* mlfq_prev;
+    struct process* mlfq_next;
+    // Encadeamento na tabela de processos (ver process_table.h).
+    struct process* hash_next;
+    struct process* live_prev;
+    struct process* live_next;
+    int state_list;
+    struct process* state_prev;
+    struct process* state_next;
 } Process;
 
-Process* process_create(dispositivo_id_t in, dispositivo_id_t out);
+// 'now' é o instante da criação.
+Process* process_create(dispositivo_id_t in, dispositivo_id_t out, int now);
 void process_destroy(Process* proc);
 
+// Libera a memória do pool de descritores de processo. Só pode ser chamada
+//   quando não existe nenhum processo (o SO chama ao ser destruído); o
+//   próximo processo criado recria o pool.
+void process_destroy_pool(void);
+
+// Muda o estado do processo no instante 'now', somando o tempo passado no
+//   estado anterior à contabilidade.
+void process_set_state(Process* proc, Process_State state, int now);
+
+// Índice do motivo de bloqueio 'on' (um só bit) em Process_Stats.blocks.
+int process_blocking_index(Process_Blocking_On on);
+// Nome curto do motivo de índice 'i', para relatórios.
+char* process_blocking_name(int i);
+
+// Muda para 'Blocking' esperando por 'on' ('id' é o dispositivo ou pid).
+void process_block(Process* proc, Process_Blocking_On on, int id, int now);
+
 #endif
@@ -0,0 +1,168 @@
+#include "process_table.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+#define PROCESS_TABLE_INITIAL_BUCKETS 16
+
+typedef enum {
+    Process_List_NONE = 0,
+    Process_List_BLOCKED,
+    Process_List_TERMINATED,
+    N_PROCESS_LISTS,
+} Process_List_Id;
+
+typedef struct {
+    Process* first;
+    Process* last;
+} Process_List;
+
+struct process_table {
+    Process** buckets;
+    int n_buckets; // Sempre potência de 2.
+    int size;
+    Process* live_first;
+    Process* live_last;
+    Process_List lists[N_PROCESS_LISTS];
+};
+
+ProcessTable* process_table_create(void) {
+    ProcessTable* table = malloc(sizeof(ProcessTable));
+    assert(table);
+
+    *table = (ProcessTable) {
+        .buckets = calloc(PROCESS_TABLE_INITIAL_BUCKETS, sizeof(Process*)),
+        .n_buckets = PROCESS_TABLE_INITIAL_BUCKETS,
+    };
+    assert(table->buckets);
+
+    return table;
+}
+
+void process_table_destroy(ProcessTable* table) {
+    while (table->live_first) {
+        Process* proc = table->live_first;
+        process_table_remove(table, proc);
+        process_destroy(proc);
+    }
+    free(table->buckets);
+    free(table);
+}
+
+int process_table_size(ProcessTable* table) {
+    return table->size;
+}
+
+static int process_table_bucket(ProcessTable* table, int pid) {
+    return (unsigned int) pid & (table->n_buckets - 1);
+}
+
+static void process_table_grow(ProcessTable* table) {
+    int n_old = table->n_buckets;
+    Process** old = table->buckets;
+
+    table->n_buckets *= 2;
+    table->buckets = calloc(table->n_buckets, sizeof(Process*));
+    assert(table->buckets);
+
+    for (int b = 0; b < n_old; b++) {
+        Process* proc = old[b];
+        while (proc) {
+            Process* next = proc->hash_next;
+            int nb = process_table_bucket(table, proc->pid);
+            proc->hash_next = table->buckets[nb];
+            table->buckets[nb] = proc;
+            proc = next;
+        }
+    }
+    free(old);
+}
+
+static void process_list_unlink(Process_List* list, Process* proc) {
+    if (proc->state_prev) proc->state_prev->state_next = proc->state_next;
+    else list->first = proc->state_next;
+    if (proc->state_next) proc->state_next->state_prev = proc->state_prev;
+    else list->last = proc->state_prev;
+    proc->state_prev = NULL;
+    proc->state_next = NULL;
+}
+
+static void process_list_append(Process_List* list, Process* proc) {
+    proc->state_prev = list->last;
+    proc->state_next = NULL;
+    if (list->last) list->last->state_next = proc;
+    else list->first = proc;
+    list->last = proc;
+}
+
+void process_table_insert(ProcessTable* table, Process* proc) {
+    assert(process_table_find(table, proc->pid) == NULL);
+
+    if (table->size >= table->n_buckets) process_table_grow(table);
+
+    int b = process_table_bucket(table, proc->pid);
+    proc->hash_next = table->buckets[b];
+    table->buckets[b] = proc;
+
+    proc->live_prev = table->live_last;
+    proc->live_next = NULL;
+    if (table->live_last) table->live_last->live_next = proc;
+    else table->live_first = proc;
+    table->live_last = proc;
+
+    proc->state_list = Process_List_NONE;
+    table->size++;
+    process_table_update(table, proc);
+}
+
+void process_table_remove(ProcessTable* table, Process* proc) {
+    Process** p = &table->buckets[process_table_bucket(table, proc->pid)];
+    while (*p && *p != proc) p = &(*p)->hash_next;
+    assert(*p == proc);
+    *p = proc->hash_next;
+    proc->hash_next = NULL;
+
+    if (proc->live_prev) proc->live_prev->live_next = proc->live_next;
+    else table->live_first = proc->live_next;
+    if (proc->live_next) proc->live_next->live_prev = proc->live_prev;
+    else table->live_last = proc->live_prev;
+    proc->live_prev = NULL;
+    proc->live_next = NULL;
+
+    if (proc->state_list != Process_List_NONE) {
+        process_list_unlink(&table->lists[proc->state_list], proc);
+        proc->state_list = Process_List_NONE;
+    }
+    table->size--;
+}
+
+Process* process_table_find(ProcessTable* table, int pid) {
+    Process* proc = table->buckets[process_table_bucket(table, pid)];
+    while (proc && proc->pid != pid) proc = proc->hash_next;
+    return proc;
+}
+
+void process_table_update(ProcessTable* table, Process* proc) {
+    Process_List_Id id = Process_List_NONE;
+    if (proc->state == Process_State_BLOCKING) id = Process_List_BLOCKED;
+    if (proc->state == Process_State_TERMINATED) id = Process_List_TERMINATED;
+    if (id == proc->state_list) return;
+
+    if (proc->state_list != Process_List_NONE) {
+        process_list_unlink(&table->lists[proc->state_list], proc);
+    }
+    if (id != Process_List_NONE) process_list_append(&table->lists[id], proc);
+    proc->state_list = id;
+}
+
+Process* process_table_first(ProcessTable* table) {
+    return table->live_first;
+}
+
+Process* process_table_first_blocked(ProcessTable* table) {
+    return table->lists[Process_List_BLOCKED].first;
+}
+
+Process* process_table_first_terminated(ProcessTable* table) {
+    return table->lists[Process_List_TERMINATED].first;
+}
@@ -0,0 +1,42 @@
+#ifndef PROCESS_TABLE_H
+#define PROCESS_TABLE_H
+
+#include "process.h"
+
+// Tabela de processos do SO, sem limite de tamanho.
+// Os processos são encontrados pelo pid em O(1) (tabela hash encadeada pelo
+//   campo 'hash_next', que dobra de tamanho quando fica cheia), e ficam em
+//   listas encadeadas pelos próprios descritores:
+//   - todos os processos vivos ('live_prev'/'live_next');
+//   - os bloqueados e os terminados ainda não destruídos, uma lista para cada
+//     ('state_prev'/'state_next'), mantidas por process_table_update.
+// Os processos prontos ficam nas filas do escalonador (ver scheduler.h).
+typedef struct process_table ProcessTable;
+
+ProcessTable* process_table_create(void);
+
+// Destrói a tabela e todos os processos que ainda estão nela.
+void process_table_destroy(ProcessTable* table);
+
+int process_table_size(ProcessTable* table);
+
+void process_table_insert(ProcessTable* table, Process* proc);
+
+// Retira o processo da tabela (não destrói o processo).
+void process_table_remove(ProcessTable* table, Process* proc);
+
+// Retorna NULL se não existir processo com esse pid.
+Process* process_table_find(ProcessTable* table, int pid);
+
+// Coloca o processo na lista correspondente ao seu estado atual; deve ser
+//   chamada a cada mudança de estado.
+void process_table_update(ProcessTable* table, Process* proc);
+
+// Primeiro processo de cada lista, ou NULL se vazia. Os seguintes são
+//   obtidos com 'live_next' ou 'state_next'; para alterar o estado de um
+//   processo durante o percurso, pegue o próximo antes.
+Process* process_table_first(ProcessTable* table);
+Process* process_table_first_blocked(ProcessTable* table);
+Process* process_table_first_terminated(ProcessTable* table);
+
+#endif // PROCESS_TABLE_H
@@ -0,0 +1,29 @@
+#ifndef QUEUE_H
+#define QUEUE_H
+
+#include <stdbool.h>
+
+// Fila circular de inteiros com capacidade fixa.
+typedef struct queue Queue;
+
+Queue* queue_create(int capacity);
+
+void queue_destroy(Queue* queue);
+
+int queue_capacity(Queue* queue);
+
+int queue_size(Queue* queue);
+
+// Espaço livre (capacity - size).
+int queue_free(Queue* queue);
+
+// Retorna false (e não insere) se a fila estiver cheia.
+bool queue_push(Queue* queue, int value);
+
+// A fila não pode estar vazia.
+int queue_pop(Queue* queue);
+
+// Primeiro valor, sem remover. A fila não pode estar vazia.
+int queue_peek(Queue* queue);
+
+#endif // QUEUE_H
@@ -0,0 +1,115 @@
+// registro.c
+// escrita assíncrona de mensagens em arquivo
+// simulador de computador
+// so24b
+
+#include "registro.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <assert.h>
+
+// tamanho do buffer, em bytes
+#define TAM_BUFFER (1 << 20)
+
+// quanto a thread que escreve no arquivo dorme quando não tem o que escrever
+#define US_ESPERA 2000
+
+// o buffer tem um produtor (quem chama registro_escreve) e um consumidor (a
+//   thread que escreve no arquivo), sem travas: 'ini' só é alterado pelo
+//   consumidor e 'fim' só pelo produtor; os dois só crescem, a posição no
+//   buffer é o resto da divisão pelo tamanho
+struct registro_t {
+  FILE *arquivo;
+  char buffer[TAM_BUFFER];
+  atomic_long ini;
+  atomic_long fim;
+  atomic_long perdidas;
+  atomic_bool terminando;
+  pthread_t escritor;
+};
+
+// escreve no arquivo tudo o que tem no buffer; retorna false se não tinha nada
+static bool esvazia_buffer(registro_t *self)
+{
+  long ini = atomic_load_explicit(&self->ini, memory_order_relaxed);
+  long fim = atomic_load_explicit(&self->fim, memory_order_acquire);
+  if (ini == fim) return false;
+  // até duas partes, se der a volta no fim do buffer
+  while (ini < fim) {
+    long pos = ini % TAM_BUFFER;
+    long n = fim - ini;
+    if (n > TAM_BUFFER - pos) n = TAM_BUFFER - pos;
+    fwrite(&self->buffer[pos], 1, n, self->arquivo);
+    ini += n;
+  }
+  atomic_store_explicit(&self->ini, ini, memory_order_release);
+  return true;
+}
+
+static void *laco_do_escritor(void *arg)
+{
+  registro_t *self = arg;
+  while (!atomic_load(&self->terminando)) {
+    if (!esvazia_buffer(self)) {
+      // nada novo: é a hora de mandar para o arquivo o que foi escrito
+      fflush(self->arquivo);
+      usleep(US_ESPERA);
+    }
+  }
+  esvazia_buffer(self);
+  return NULL;
+}
+
+registro_t *registro_cria(char *nome)
+{
+  FILE *arquivo = fopen(nome, "w");
+  if (arquivo == NULL) return NULL;
+  registro_t *self = malloc(sizeof(*self));
+  assert(self != NULL);
+  self->arquivo = arquivo;
+  atomic_init(&self->ini, 0);
+  atomic_init(&self->fim, 0);
+  atomic_init(&self->perdidas, 0);
+  atomic_init(&self->terminando, false);
+  pthread_create(&self->escritor, NULL, laco_do_escritor, self);
+  return self;
+}
+
+void registro_destroi(registro_t *self)
+{
+  atomic_store(&self->terminando, true);
+  pthread_join(self->escritor, NULL);
+  long perdidas = atomic_load(&self->perdidas);
+  if (perdidas > 0) {
+    fprintf(self->arquivo, "registro: %ld mensagens perdidas\n", perdidas);
+  }
+  fclose(self->arquivo);
+  free(self);
+}
+
+void registro_escreve(registro_t *self, char *msg)
+{
+  long n = strlen(msg);
+  long fim = atomic_load_explicit(&self->fim, memory_order_relaxed);
+  long ini = atomic_load_explicit(&self->ini, memory_order_acquire);
+  if (TAM_BUFFER - (fim - ini) < n + 1) {
+    atomic_fetch_add_explicit(&self->perdidas, 1, memory_order_relaxed);
+    return;
+  }
+  for (long i = 0; i < n; i++) {
+    self->buffer[(fim + i) % TAM_BUFFER] = msg[i];
+  }
+  self->buffer[(fim + n) % TAM_BUFFER] = '\n';
+  atomic_store_explicit(&self->fim, fim + n + 1, memory_order_release);
+}
+
+long registro_perdidas(registro_t *self)
+{
+  return atomic_load_explicit(&self->perdidas, memory_order_relaxed);
+}
@@ -0,0 +1,30 @@
+// registro.h
+// escrita assíncrona de mensagens em arquivo
+// simulador de computador
+// so24b
+
+#ifndef REGISTRO_H
+#define REGISTRO_H
+
+// as mensagens são colocadas num buffer circular e escritas no arquivo por
+//   outra thread, em blocos; quem escreve nunca espera pelo arquivo
+// se o buffer estiver cheio, a mensagem é descartada e contada; o número de
+//   mensagens perdidas é escrito no final do arquivo
+// só uma thread pode escrever mensagens em um registro
+
+typedef struct registro_t registro_t;
+
+// cria um registro que escreve no arquivo 'nome' (que é truncado)
+// retorna NULL se não conseguir criar o arquivo
+registro_t *registro_cria(char *nome);
+
+// escreve o que ainda está no buffer, fecha o arquivo e destrói o registro
+void registro_destroi(registro_t *self);
+
+// coloca a mensagem 'msg' (seguida de fim de linha) no registro
+void registro_escreve(registro_t *self, char *msg);
+
+// retorna o número de mensagens descartadas por falta de espaço
+long registro_perdidas(registro_t *self);
+
+#endif // REGISTRO_H
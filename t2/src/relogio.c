@@ -9,13 +9,26 @@
 #include <time.h>
 #include <assert.h>
 
-struct relogio_t {
-  // que horas são (em tics)
-  int agora;
-  // quanto tempo até gerar uma interrupção
+typedef struct {
+  // quanto tempo até gerar uma interrupção (0 se desligado)
   int t_ate_interrupcao;
+  // valor com que o timer é rearmado quando gera interrupção (0 se não é
+  //   periódico)
+  int periodo;
   // 1 se está gerando interrupção, 0 se não
   int interrupcao;
+} relogio_timer_t;
+
+struct relogio_t {
+  // que horas são (em tics)
+  int agora;
+  relogio_timer_t timers[RELOGIO_N_TIMERS];
+  // instante real da criação do relógio, e parte em ns do tempo real lido
+  //   junto com os segundos
+  struct timespec criacao;
+  int ns_lido;
+  // controlador de interrupções (NULL se não tem)
+  pic_t *pic;
 };
 
 relogio_t *relogio_cria(void)
@@ -25,6 +38,12 @@ relogio_t *relogio_cria(void)
   assert(self != NULL);
 
   self->agora = 0;
+  for (int t = 0; t < RELOGIO_N_TIMERS; t++) {
+    self->timers[t] = (relogio_timer_t){ 0, 0, 0 };
+  }
+  clock_gettime(CLOCK_MONOTONIC, &self->criacao);
+  self->ns_lido = 0;
+  self->pic = NULL;
 
   return self;
 }
@@ -34,14 +53,24 @@ void relogio_destroi(relogio_t *self)
   free(self);
 }
 
+void relogio_define_pic(relogio_t *self, pic_t *pic)
+{
+  self->pic = pic;
+}
+
 void relogio_tictac(relogio_t *self)
 {
   self->agora++;
-  // vê se tem que gerar interrupção
-  if (self->t_ate_interrupcao != 0) {
-    self->t_ate_interrupcao--;
-    if (self->t_ate_interrupcao == 0) {
-      self->interrupcao = 1;
+  // vê se algum timer tem que gerar interrupção
+  for (int t = 0; t < RELOGIO_N_TIMERS; t++) {
+    relogio_timer_t *timer = &self->timers[t];
+    if (timer->t_ate_interrupcao != 0) {
+      timer->t_ate_interrupcao--;
+      if (timer->t_ate_interrupcao == 0) {
+        timer->interrupcao = 1;
+        timer->t_ate_interrupcao = timer->periodo;
+        if (self->pic != NULL) pic_pede(self->pic, IRQ_RELOGIO);
+      }
     }
   }
 }
@@ -51,10 +80,54 @@ int relogio_agora(relogio_t *self)
   return self->agora;
 }
 
+// cada timer tem 3 ids, a partir de RELOGIO_ID_TIMERS (ver relogio.h)
+// timer correspondente ao id, e qual dos ids dele (0 a 2) em *pcampo; NULL
+//   se o id não é de um timer
+static relogio_timer_t *relogio_acha_timer(relogio_t *self, int id, int *pcampo)
+{
+  if (id < RELOGIO_ID_TIMERS || id >= RELOGIO_ID_TIMERS + 3 * RELOGIO_N_TIMERS) return NULL;
+  *pcampo = (id - RELOGIO_ID_TIMERS) % 3;
+  return &self->timers[(id - RELOGIO_ID_TIMERS) / 3];
+}
+
+// segundos de tempo real desde a criação do relógio; guarda a parte em ns
+static int relogio_le_tempo_real(relogio_t *self)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  long seg = ts.tv_sec - self->criacao.tv_sec;
+  long ns = ts.tv_nsec - self->criacao.tv_nsec;
+  if (ns < 0) {
+    seg--;
+    ns += 1000000000L;
+  }
+  self->ns_lido = ns;
+  return seg;
+}
+
+// número do primeiro timer que está gerando interrupção, -1 se nenhum
+static int relogio_qual_timer(relogio_t *self)
+{
+  for (int t = 0; t < RELOGIO_N_TIMERS; t++) {
+    if (self->timers[t].interrupcao) return t;
+  }
+  return -1;
+}
+
 err_t relogio_leitura(void *disp, int id, int *pvalor)
 {
   relogio_t *self = disp;
   err_t err = ERR_OK;
+  int campo;
+  relogio_timer_t *timer = relogio_acha_timer(self, id, &campo);
+  if (timer != NULL) {
+    switch (campo) {
+      case 0: *pvalor = timer->t_ate_interrupcao; break;
+      case 1: *pvalor = timer->periodo;           break;
+      case 2: *pvalor = timer->interrupcao;       break;
+    }
+    return ERR_OK;
+  }
   switch (id) {
     case 0:
       *pvalor = self->agora;
@@ -63,10 +136,19 @@ err_t relogio_leitura(void *disp, int id, int *pvalor)
       *pvalor = clock()/(CLOCKS_PER_SEC/1000);
       break;
     case 2:
-      *pvalor = self->t_ate_interrupcao;
+      *pvalor = self->timers[0].t_ate_interrupcao;
       break;
     case 3:
-      *pvalor = self->interrupcao;
+      *pvalor = relogio_qual_timer(self) >= 0 ? 1 : 0;
+      break;
+    case 4:
+      *pvalor = relogio_qual_timer(self);
+      break;
+    case RELOGIO_ID_REAL_SEG:
+      *pvalor = relogio_le_tempo_real(self);
+      break;
+    case RELOGIO_ID_REAL_NS:
+      *pvalor = self->ns_lido;
       break;
     default: 
       err = ERR_END_INV;
@@ -78,12 +160,32 @@ err_t relogio_escrita(void *disp, int id, int pvalor)
 {
   relogio_t *self = disp;
   err_t err = ERR_OK;
+  int campo;
+  relogio_timer_t *timer = relogio_acha_timer(self, id, &campo);
+  if (timer != NULL) {
+    if (pvalor < 0 && campo != 2) return ERR_OP_INV;
+    switch (campo) {
+      case 0: timer->t_ate_interrupcao = pvalor;          break;
+      case 1: timer->periodo = pvalor;                    break;
+      case 2: timer->interrupcao = (pvalor == 0) ? 0 : 1; break;
+    }
+    return ERR_OK;
+  }
   switch (id) {
     case 2:
-      self->t_ate_interrupcao = pvalor;
+      self->timers[0].t_ate_interrupcao = pvalor;
       break;
     case 3:
-      self->interrupcao = (pvalor == 0) ? 0 : 1;
+      if (pvalor == 0) {
+        for (int t = 0; t < RELOGIO_N_TIMERS; t++) self->timers[t].interrupcao = 0;
+      }
+      break;
+    case 4:
+      if (pvalor < 0 || pvalor >= RELOGIO_N_TIMERS) {
+        err = ERR_OP_INV;
+      } else {
+        self->timers[pvalor].interrupcao = 0;
+      }
       break;
     default: 
       err = ERR_END_INV;
@@ -10,6 +10,16 @@
 // registra a passagem do tempo
 
 #include "err.h"
+#include "pic.h"
+
+// número de timers do relógio
+#define RELOGIO_N_TIMERS 4
+
+// ids dos dispositivos do relógio que dependem do número de timers (ver
+//   abaixo): o primeiro dos timers, e os de tempo real, que vêm depois deles
+#define RELOGIO_ID_TIMERS 5
+#define RELOGIO_ID_REAL_SEG (RELOGIO_ID_TIMERS + 3 * RELOGIO_N_TIMERS)
+#define RELOGIO_ID_REAL_NS  (RELOGIO_ID_REAL_SEG + 1)
 
 typedef struct relogio_t relogio_t;
 
@@ -20,6 +30,10 @@ relogio_t *relogio_cria(void);
 // nenhuma outra operação pode ser realizada no relógio após esta chamada
 void relogio_destroi(relogio_t *self);
 
+// define o controlador de interrupções onde o relógio pede interrupção
+//   (na linha IRQ_RELOGIO) quando um timer chega a 0
+void relogio_define_pic(relogio_t *self, pic_t *pic);
+
 // registra a passagem de uma unidade de tempo
 // esta função é chamada pelo controlador após a execução de cada instrução
 void relogio_tictac(relogio_t *self);
@@ -27,11 +41,28 @@ void relogio_tictac(relogio_t *self);
 // retorna a hora atual do sistema, em unidades de tempo
 int relogio_agora(relogio_t *self);
 
+// O relógio tem RELOGIO_N_TIMERS timers independentes. Cada um conta o tempo
+//   até gerar uma interrupção (0 se está desligado); quando chega a 0, liga o
+//   seu sinalizador de interrupção e, se tiver um período (diferente de 0),
+//   recomeça a contar a partir dele.
 // Funções para acessar o relógio como dispositivo de E/S, com id:
 //   '0' para ler o relógio local (contador de instruções)
 //   '1' para ler o tempo de CPU consumido pelo simulador (em ms)
-//   '2' para ler ou escrever em quanto tempo uma interrupção será gerada
-//   '3' para ler ou escrever se uma interrupção está sendo pedida
+//   '2' para ler ou escrever em quanto tempo o timer 0 vai gerar uma interrupção
+//   '3' para ler se algum timer está pedindo interrupção, ou escrever 0 para
+//       desligar os pedidos de todos
+//   '4' para ler o número do timer de menor número que está pedindo interrupção
+//       (-1 se nenhum), ou escrever o número de um timer para desligar o pedido
+//       dele
+//   '5 + 3*t' para ler ou escrever em quanto tempo o timer t vai gerar uma
+//       interrupção
+//   '6 + 3*t' para ler ou escrever o período do timer t (0 se não é periódico)
+//   '7 + 3*t' para ler ou escrever se o timer t está pedindo interrupção
+//   RELOGIO_ID_REAL_SEG (17) para ler o tempo real (monotônico) desde a
+//       criação do relógio, em segundos; a leitura guarda também a parte em
+//       ns desse instante
+//   RELOGIO_ID_REAL_NS (18) para ler a parte em ns (0 a 999999999) do
+//       instante lido com RELOGIO_ID_REAL_SEG
 // Devem seguir o protocolo f_leitura_t e f_escrita_t declarados em es.h
 err_t relogio_leitura(void *disp, int id, int *pvalor);
 err_t relogio_escrita(void *disp, int id, int pvalor);
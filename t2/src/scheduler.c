@@ -0,0 +1,258 @@
+#include "scheduler.h"
+#include "prio_queue.h"
+#include "mlfq.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ROUND-ROBIN {{{1
+// Uma fila só, sem realimentação: um MLFQ de um nível.
+
+static void* rr_create(void) {
+    return mlfq_create(1);
+}
+
+static void rr_destroy(void* sched) {
+    mlfq_destroy(sched);
+}
+
+static void rr_enqueue(void* sched, Process* proc) {
+    mlfq_push(sched, proc);
+}
+
+static Process* rr_pick(void* sched) {
+    return mlfq_pop(sched);
+}
+
+static void rr_remove(void* sched, Process* proc) {
+    mlfq_remove(sched, proc);
+}
+
+static const Scheduler_Policy scheduler_round_robin = {
+    .name = "rr",
+    .create = rr_create,
+    .destroy = rr_destroy,
+    .enqueue = rr_enqueue,
+    .pick = rr_pick,
+    .remove = rr_remove,
+};
+
+// PRIORIDADE {{{1
+// Escolhe o pronto de menor 'priority'. A prioridade é recalculada a cada vez
+//   que o processo sai da CPU: média entre a anterior e a fração do quantum
+//   usada, então processos que bloqueiam cedo (limitados por E/S) ficam com
+//   prioridade melhor.
+
+static void* prio_create(void) {
+    return prio_queue_create();
+}
+
+static void prio_destroy(void* sched) {
+    prio_queue_destroy(sched);
+}
+
+static void prio_enqueue(void* sched, Process* proc) {
+    prio_queue_push(sched, proc);
+}
+
+static Process* prio_pick(void* sched) {
+    return prio_queue_pop(sched);
+}
+
+static void prio_remove(void* sched, Process* proc) {
+    prio_queue_remove(sched, proc);
+}
+
+static void prio_on_leave(void* sched, Process* proc, float used) {
+    proc->priority = (proc->priority + used) / 2;
+}
+
+static const Scheduler_Policy scheduler_priority = {
+    .name = "prioridade",
+    .create = prio_create,
+    .destroy = prio_destroy,
+    .enqueue = prio_enqueue,
+    .pick = prio_pick,
+    .remove = prio_remove,
+    .on_preempt = prio_on_leave,
+    .on_block = prio_on_leave,
+};
+
+// MLFQ {{{1
+// Uma fila por nível, com quantum dobrando a cada nível. O processo desce um
+//   nível se usar todo o quantum, sobe um quando acorda depois de bloquear
+//   (não usou todo o quantum), e a cada
+//   MLFQ_BOOST_INTERVAL ticks todos voltam ao nível 0 para que ninguém
+//   fique sem CPU.
+// Os processos que não estão nas filas durante o 'boost' (executando ou
+//   bloqueados) voltam ao nível 0 na próxima vez que o escalonador mexer neles,
+//   comparando 'mlfq_epoch' com o número de 'boosts' já feitos.
+
+#define MLFQ_LEVELS 3
+#define MLFQ_BOOST_INTERVAL 20 // Em ticks do relógio.
+
+typedef struct {
+    Mlfq* queue;
+    int boost_timer;
+    int epoch;
+} Mlfq_Scheduler;
+
+static void* mlfq_sched_create(void) {
+    Mlfq_Scheduler* self = malloc(sizeof(Mlfq_Scheduler));
+    assert(self);
+
+    *self = (Mlfq_Scheduler) {
+        .queue = mlfq_create(MLFQ_LEVELS),
+        .boost_timer = MLFQ_BOOST_INTERVAL,
+        .epoch = 0,
+    };
+    return self;
+}
+
+static void mlfq_sched_destroy(void* sched) {
+    Mlfq_Scheduler* self = sched;
+    mlfq_destroy(self->queue);
+    free(self);
+}
+
+// Aplica ao processo um 'boost' que aconteceu enquanto ele não estava na fila.
+static void mlfq_sched_sync(Mlfq_Scheduler* self, Process* proc) {
+    if (proc->mlfq_epoch != self->epoch) {
+        proc->mlfq_epoch = self->epoch;
+        proc->mlfq_level = 0;
+    }
+}
+
+static void mlfq_sched_enqueue(void* sched, Process* proc) {
+    Mlfq_Scheduler* self = sched;
+    mlfq_sched_sync(self, proc);
+    mlfq_push(self->queue, proc);
+}
+
+static Process* mlfq_sched_pick(void* sched) {
+    Mlfq_Scheduler* self = sched;
+    return mlfq_pop(self->queue);
+}
+
+static void mlfq_sched_remove(void* sched, Process* proc) {
+    Mlfq_Scheduler* self = sched;
+    mlfq_remove(self->queue, proc);
+}
+
+static void mlfq_sched_on_tick(void* sched) {
+    Mlfq_Scheduler* self = sched;
+    if (--self->boost_timer > 0) return;
+
+    self->boost_timer = MLFQ_BOOST_INTERVAL;
+    self->epoch++;
+    mlfq_boost(self->queue);
+}
+
+static void mlfq_sched_on_preempt(void* sched, Process* proc, float used) {
+    Mlfq_Scheduler* self = sched;
+    mlfq_sched_sync(self, proc);
+    // Usou todo o quantum, desce um nível.
+    if (proc->mlfq_level < MLFQ_LEVELS - 1) proc->mlfq_level++;
+}
+
+static void mlfq_sched_on_wake(void* sched, Process* proc) {
+    Mlfq_Scheduler* self = sched;
+    mlfq_sched_sync(self, proc);
+    // Bloqueou antes do fim do quantum, volta um nível acima.
+    if (proc->mlfq_level > 0) proc->mlfq_level--;
+}
+
+static int mlfq_sched_quantum(void* sched, Process* proc) {
+    return SCHEADULER_QUANTUM << proc->mlfq_level;
+}
+
+static const Scheduler_Policy scheduler_mlfq = {
+    .name = "mlfq",
+    .create = mlfq_sched_create,
+    .destroy = mlfq_sched_destroy,
+    .enqueue = mlfq_sched_enqueue,
+    .pick = mlfq_sched_pick,
+    .remove = mlfq_sched_remove,
+    .on_tick = mlfq_sched_on_tick,
+    .on_preempt = mlfq_sched_on_preempt,
+    .on_wake = mlfq_sched_on_wake,
+    .quantum = mlfq_sched_quantum,
+};
+
+// ESCALONADOR {{{1
+
+static const Scheduler_Policy* scheduler_policies[] = {
+    &scheduler_round_robin,
+    &scheduler_priority,
+    &scheduler_mlfq,
+};
+#define N_POLICIES (sizeof(scheduler_policies) / sizeof(scheduler_policies[0]))
+
+struct scheduler {
+    const Scheduler_Policy* policy;
+    void* sched;
+};
+
+Scheduler* scheduler_create(char* name) {
+    for (int i = 0; i < N_POLICIES; i++) {
+        if (strcmp(scheduler_policies[i]->name, name) != 0) continue;
+
+        Scheduler* scheduler = malloc(sizeof(Scheduler));
+        assert(scheduler);
+        scheduler->policy = scheduler_policies[i];
+        scheduler->sched = scheduler->policy->create ? scheduler->policy->create() : NULL;
+        return scheduler;
+    }
+    return NULL;
+}
+
+void scheduler_destroy(Scheduler* scheduler) {
+    if (scheduler->policy->destroy) scheduler->policy->destroy(scheduler->sched);
+    free(scheduler);
+}
+
+char* scheduler_name(Scheduler* scheduler) {
+    return scheduler->policy->name;
+}
+
+char* scheduler_policy_name(int i) {
+    if (i < 0 || i >= N_POLICIES) return NULL;
+    return scheduler_policies[i]->name;
+}
+
+void scheduler_enqueue(Scheduler* scheduler, Process* proc) {
+    if (scheduler->policy->enqueue) scheduler->policy->enqueue(scheduler->sched, proc);
+}
+
+Process* scheduler_pick(Scheduler* scheduler) {
+    if (!scheduler->policy->pick) return NULL;
+    return scheduler->policy->pick(scheduler->sched);
+}
+
+void scheduler_remove(Scheduler* scheduler, Process* proc) {
+    if (scheduler->policy->remove) scheduler->policy->remove(scheduler->sched, proc);
+}
+
+void scheduler_on_tick(Scheduler* scheduler) {
+    if (scheduler->policy->on_tick) scheduler->policy->on_tick(scheduler->sched);
+}
+
+void scheduler_on_preempt(Scheduler* scheduler, Process* proc, float used) {
+    if (scheduler->policy->on_preempt) scheduler->policy->on_preempt(scheduler->sched, proc, used);
+}
+
+void scheduler_on_block(Scheduler* scheduler, Process* proc, float used) {
+    if (scheduler->policy->on_block) scheduler->policy->on_block(scheduler->sched, proc, used);
+}
+
+void scheduler_on_wake(Scheduler* scheduler, Process* proc) {
+    if (scheduler->policy->on_wake) scheduler->policy->on_wake(scheduler->sched, proc);
+}
+
+int scheduler_quantum(Scheduler* scheduler, Process* proc) {
+    if (!scheduler->policy->quantum) return SCHEADULER_QUANTUM;
+    return scheduler->policy->quantum(scheduler->sched, proc);
+}
+
+// vim: foldmethod=marker
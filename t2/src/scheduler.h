@@ -0,0 +1,59 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include "process.h"
+
+// Quantum base, em ticks do relógio (INTERVALO_INTERRUPCAO instruções, ver so.c).
+#define SCHEADULER_QUANTUM 2
+
+// Interface entre o SO e uma política de escalonamento.
+// O SO avisa a política das transições de estado dos processos e pede a ela o
+//   próximo processo a executar. Qualquer função pode ser NULL (não faz nada).
+// 'sched' é o estado da política, criado por 'create'.
+typedef struct {
+    char* name;
+    void* (*create)(void);
+    void (*destroy)(void* sched);
+    // O processo está pronto para executar.
+    void (*enqueue)(void* sched, Process* proc);
+    // Retira e retorna o próximo processo a executar, ou NULL se não tem nenhum pronto.
+    Process* (*pick)(void* sched);
+    // Retira o processo das estruturas da política (ele vai ser destruído).
+    void (*remove)(void* sched, Process* proc);
+    // Passou um tick do relógio.
+    void (*on_tick)(void* sched);
+    // O processo perdeu a CPU por fim de quantum (será colocado em seguida na fila
+    //   com 'enqueue'). 'used' é a fração do quantum que ele usou (0 a 1).
+    void (*on_preempt)(void* sched, Process* proc, float used);
+    // O processo saiu da CPU porque bloqueou.
+    void (*on_block)(void* sched, Process* proc, float used);
+    // O processo desbloqueou (será colocado em seguida na fila com 'enqueue').
+    void (*on_wake)(void* sched, Process* proc);
+    // Quantum do processo escolhido, em ticks do relógio.
+    // Se NULL, é SCHEADULER_QUANTUM.
+    int (*quantum)(void* sched, Process* proc);
+} Scheduler_Policy;
+
+typedef struct scheduler Scheduler;
+
+// Cria um escalonador com a política de nome 'name'.
+// Retorna NULL se não existir política com esse nome.
+Scheduler* scheduler_create(char* name);
+
+void scheduler_destroy(Scheduler* scheduler);
+
+char* scheduler_name(Scheduler* scheduler);
+
+// Nome da i-ésima política disponível, ou NULL se i >= número de políticas.
+char* scheduler_policy_name(int i);
+
+void scheduler_enqueue(Scheduler* scheduler, Process* proc);
+Process* scheduler_pick(Scheduler* scheduler);
+void scheduler_remove(Scheduler* scheduler, Process* proc);
+void scheduler_on_tick(Scheduler* scheduler);
+void scheduler_on_preempt(Scheduler* scheduler, Process* proc, float used);
+void scheduler_on_block(Scheduler* scheduler, Process* proc, float used);
+void scheduler_on_wake(Scheduler* scheduler, Process* proc);
+int scheduler_quantum(Scheduler* scheduler, Process* proc);
+
+#endif // SCHEDULER_H
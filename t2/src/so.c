@@ -13,30 +13,105 @@
 #include "programa.h"
 #include "tabpag.h"
 #include "process.h"
+#include "process_table.h"
+#include "wait_queue.h"
+#include "timer_queue.h"
+#include "scheduler.h"
 
 #include <stdlib.h>
 #include <stdbool.h>
 #include <assert.h>
+#include <stdio.h>
 #include <string.h>
 
 // CONSTANTES E TIPOS {{{1
-// intervalo entre interrupções do relógio
+// duração de um tick do relógio: unidade do quantum
 #define INTERVALO_INTERRUPCAO 50   // em instruções executadas
-#define MAX_PROCESSES 4
-#define SCHEADULER_QUANTUM 2 // Em interrupções do clock.
-#define NO_PROCESS_RUNNING -1
-
+// timers do relógio usados pelo SO: um para o escalonamento (fim do quantum),
+//   outro para acordar os processos dormindo
+#define TIMER_ESCALONADOR 0
+#define TIMER_SONO        1
+
+// fases do tratamento de interrupção medidas no perfil do SO
+typedef enum {
+  FASE_SALVA,
+  FASE_TRATA_IRQ,
+  FASE_PENDENCIAS,
+  FASE_ESCALONA,
+  FASE_DESPACHA,
+  N_FASES
+} fase_t;
+static char *nomes_das_fases[N_FASES] = {
+  "salva", "trata_irq", "pendencias", "escalona", "despacha"
+};
+// caracteres de saída que o SO guarda para cada processo (ver SO_ESCR e
+//   SO_ESCR_STR)
+#define TAM_BUFFER_SAIDA 64
+// caracteres de entrada que o SO guarda para cada terminal (ver SO_LE_LINHA)
+#define TAM_BUFFER_ENTRADA 128
+#define N_TERMINAIS 4
+// capacidade de cada pipe, em valores (ver SO_PIPE)
+#define TAM_PIPE 32
+// número máximo de pipes; a memória deles só é liberada com o SO, porque
+//   qualquer processo pode usar um pipe pelo número a qualquer momento
+#define N_PIPES 16
+// tamanho máximo do nome de um segmento compartilhado (ver SO_SHM)
+#define TAM_NOME_SEGMENTO 32
 // Não tem processos nem memória virtual, mas é preciso usar a paginação,
 //   pelo menos para implementar relocação, já que os programas estão sendo
 //   todos montados para serem executados no endereço 0 e o endereço 0
 //   físico é usado pelo hardware nas interrupções.
-// Os programas estão sendo carregados no início de um quadro, e usam quantos
-//   quadros forem necessárias. Para isso a variável quadro_livre contém
-//   o número do primeiro quadro da memória principal que ainda não foi usado.
-//   Na carga do processo, a tabela de páginas (deveria ter uma por processo,
-//   mas não tem processo) é alterada para que o endereço virtual 0 resulte
-//   no quadro onde o programa foi carregado. Com isso, o programa carregado
-//   é acessível, mas o acesso ao anterior é perdido.
+// Os programas são carregados em quadros livres da memória principal, e a
+//   tabela de páginas do processo é alterada para que suas páginas resultem
+//   nesses quadros. Cada quadro tem um contador de referências (das tabelas de
+//   páginas e dos segmentos compartilhados que o usam), e volta para a lista
+//   de quadros livres quando o contador chega a 0.
+
+// entrada de um terminal já lida do teclado pelo SO, ainda não entregue a
+//   nenhum processo
+typedef struct {
+  Queue* buffer;
+  // número de linhas completas ('\n') no buffer
+  int linhas;
+} Entrada_Terminal;
+
+// segmento de memória compartilhada (ver SO_SHM)
+// o segmento tem uma referência em cada um dos seus quadros, e cada
+//   processo que o mapeou tem outra
+typedef struct {
+  char nome[TAM_NOME_SEGMENTO];
+  int n_quadros;
+  int* quadros;
+} Segmento;
+
+// pipe (ver SO_PIPE)
+typedef struct {
+  Queue* valores;
+  // pids dos processos ainda não destruídos que já enviaram valores ao pipe
+  int* escritores;
+  int n_escritores;
+  // algum processo já enviou ao pipe; quando não tiver mais escritores, o
+  //   pipe vazio chegou ao fim
+  bool teve_escritor;
+} Pipe;
+
+// semáforo (ver SO_SEM_CRIA)
+typedef struct {
+  int valor;
+  WaitQueue* espera;
+} Semaforo;
+
+// futex com processos esperando (ver SO_FUTEX_ESPERA)
+typedef struct {
+  int endereco; // físico
+  WaitQueue* espera;
+} Futex;
+
+// contabilidade de um processo que já foi destruído
+typedef struct {
+  int pid;
+  Process_Stats stats;
+} Finished_Process;
 
 struct so_t {
   cpu_t *cpu;
@@ -47,22 +122,76 @@ struct so_t {
   console_t *console;
   bool erro_interno;
   // t1: tabela de processos, processo corrente, pendências, etc
-  Process* process_table[MAX_PROCESSES];
-  int current_process;
-  int quantum;
-  // primeiro quadro da memória que está livre (quadros anteriores estão ocupados)
-  // t2: com memória virtual, o controle de memória livre e ocupada é mais
-  // completo que isso
-  int quadro_livre;
+  ProcessTable* process_table;
+  Process* current_process;
+  // instante (em instruções) em que termina o quantum do processo corrente,
+  //   e duração dele (em ticks)
+  int fim_do_quantum;
+  int quantum_inicial;
+  // processos no estado 'Ready'
+  int n_prontos;
+  // instante do último tick contado para o escalonador
+  int ultimo_tick;
+  // instante (em instruções) em que o processo corrente foi escolhido
+  int dispatch_time;
+  // tabela de páginas colocada na MMU pelo último despacho; se um processo
+  //   com a mesma tabela for escolhido, não precisa trocar
+  tabpag_t* tabpag_despachada;
+  Scheduler* scheduler;
+  // não existem mais processos
+  bool terminou;
+  // arquivo do programa do processo inicial
+  char programa_inicial[100];
+  // contabilidade (ver so_metricas e so_imprime_relatorio)
+  int n_trocas_de_contexto;
+  int n_terminados;
+  Finished_Process* terminados;
+  // t2: buffers de entrada dos terminais, indexados por 'in / 4'
+  Entrada_Terminal entradas[N_TERMINAIS];
+  // pipes, indexados pelo número do pipe
+  Pipe pipes[N_PIPES];
+  int n_pipes;
+  // t2: quadros da memória principal: referências a cada quadro, e pilha
+  //   dos quadros livres
+  int n_quadros;
+  int* ref_quadros;
+  int* quadros_livres;
+  int n_quadros_livres;
+  // segmentos de memória compartilhada existentes
+  Segmento* segmentos;
+  int n_segmentos;
+  // semáforos, indexados pelo número
+  Semaforo* semaforos;
+  int n_semaforos;
+  // futexes com processos esperando; um futex sem processos é removido
+  Futex* futexes;
+  int n_futexes;
+  // processos dormindo (SO_DORME), pelo instante de acordar
+  TimerQueue* dormindo;
+  // tempo real gasto em cada fase do tratamento de interrupção
+  perfil_t *perfil;
   // uma tabela de páginas para poder usar a MMU
   // t2: com processos, não tem esta tabela global, tem que ter uma para
   //     cada processo
   // tabpag_t *tabpag_global;
 };
 
-Process* process_table_find(so_t* os, int pid);
-void process_receive_input(es_t* io, Process* proc);
-void process_send_output(es_t* io, Process* proc);
+void process_receive_input(so_t* self, Process* proc);
+static void so_esvazia_saida(so_t *self, Process* proc);
+static bool so_escr_str(so_t *self, Process* proc);
+static void so_escr_bufferizada(so_t *self, Process* proc);
+static Queue* so_saida_do_processo(so_t *self, Process* proc);
+static Entrada_Terminal* so_entrada_do_processo(so_t *self, Process* proc);
+static void so_le_teclados(so_t *self);
+static bool so_le_linha(so_t *self, Process* proc);
+static bool so_envia(so_t *self, Process* proc, int* pipe);
+static bool so_recebe(so_t *self, Process* proc, int* pipe);
+static void so_fecha_pipes(so_t *self, Process* proc);
+static bool so_pipe_no_fim(Pipe* pipe);
+static int so_aloca_quadro(so_t *self);
+static void so_libera_quadro(so_t *self, int quadro);
+static void so_libera_memoria(so_t *self, Process* proc);
+static void so_tira_da_espera(so_t *self, Process* proc);
 
 // função de tratamento de interrupção (entrada no SO)
 static int so_trata_interrupcao(void *argC, int reg_A);
@@ -80,8 +209,11 @@ static bool so_copia_str_do_processo(so_t *self, int tam, char str[tam],
 
 
 so_t *so_cria(cpu_t *cpu, mem_t *mem, mem_t* mem_secundaria, mmu_t *mmu,
-              es_t *es, console_t *console)
+              es_t *es, console_t *console, char *escalonador)
 {
+  Scheduler* scheduler = scheduler_create(escalonador);
+  if (scheduler == NULL) return NULL;
+
   so_t *self = malloc(sizeof(*self));
   assert(self != NULL);
 
@@ -92,13 +224,36 @@ so_t *so_cria(cpu_t *cpu, mem_t *mem, mem_t* mem_secundaria, mmu_t *mmu,
   self->es = es;
   self->console = console;
   self->erro_interno = false;
-  self->current_process = NO_PROCESS_RUNNING;
-  self->quantum = SCHEADULER_QUANTUM;
+  self->current_process = NULL;
+  self->fim_do_quantum = 0;
+  self->quantum_inicial = SCHEADULER_QUANTUM;
+  self->n_prontos = 0;
+  self->ultimo_tick = 0;
+  self->dispatch_time = 0;
+  self->tabpag_despachada = NULL;
+  self->scheduler = scheduler;
+  self->terminou = false;
+  strcpy(self->programa_inicial, "init.maq");
+  self->n_trocas_de_contexto = 0;
+  self->n_terminados = 0;
+  self->terminados = NULL;
+  self->n_pipes = 0;
+  self->process_table = process_table_create();
+  for (int t = 0; t < N_TERMINAIS; t++) {
+    self->entradas[t] = (Entrada_Terminal) { .buffer = queue_create(TAM_BUFFER_ENTRADA) };
+  }
 
   // quando a CPU executar uma instrução CHAMAC, deve chamar a função
   //   so_trata_interrupcao, com primeiro argumento um ptr para o SO
   cpu_define_chamaC(self->cpu, so_trata_interrupcao, self);
 
+  // o estado dos processos é trocado direto no banco de registradores da CPU,
+  //   sem passar pela memória
+  cpu_define_salvamento(self->cpu, cpu_salva_no_banco);
+
+  // o operador pode pedir o relatório de contabilidade com o comando 'R'
+  console_define_comando(self->console, 'R', so_imprime_relatorio, self);
+
   // coloca o tratador de interrupção na memória
   // quando a CPU aceita uma interrupção, passa para modo supervisor,
   //   salva seu estado à partir do endereço 0, e desvia para o endereço
@@ -114,11 +269,19 @@ so_t *so_cria(cpu_t *cpu, mem_t *mem, mem_t* mem_secundaria, mmu_t *mmu,
   }
 
   // programa o relógio para gerar uma interrupção após INTERVALO_INTERRUPCAO
-  if (es_escreve(self->es, D_RELOGIO_TIMER, INTERVALO_INTERRUPCAO) != ERR_OK) {
+  if (es_escreve(self->es, D_RELOGIO_TIMER_0 + 3 * TIMER_ESCALONADOR,
+                 INTERVALO_INTERRUPCAO) != ERR_OK) {
     console_printf("SO: problema na programação do timer");
     self->erro_interno = true;
   }
 
+  // habilita no controlador de interrupções as interrupções que o SO trata
+  int mascara = 1 << IRQ_RELOGIO | 1 << IRQ_TECLADO | 1 << IRQ_TELA;
+  if (es_escreve(self->es, D_PIC_MASCARA, mascara) != ERR_OK) {
+    console_printf("SO: problema na programação do controlador de interrupções");
+    self->erro_interno = true;
+  }
+
   // inicializa a tabela de páginas global, e entrega ela para a MMU
   // t2: com processos, essa tabela não existiria, teria uma por processo, que
   //     deve ser colocada na MMU quando o processo é despachado para execução
@@ -127,14 +290,63 @@ so_t *so_cria(cpu_t *cpu, mem_t *mem, mem_t* mem_secundaria, mmu_t *mmu,
   // define o primeiro quadro livre de memória como o seguinte àquele que
   //   contém o endereço 99 (as 100 primeiras posições de memória (pelo menos)
   //   não vão ser usadas por programas de usuário)
-  // t2: o controle de memória livre deve ser mais aprimorado que isso
-  self->quadro_livre = 99 / TAM_PAGINA + 1;
+  // os quadros livres ficam numa pilha, os de número menor no topo
+  self->n_quadros = mem_tam(self->mem) / TAM_PAGINA;
+  self->ref_quadros = calloc(self->n_quadros, sizeof(int));
+  self->quadros_livres = malloc(self->n_quadros * sizeof(int));
+  assert(self->ref_quadros != NULL && self->quadros_livres != NULL);
+  self->n_quadros_livres = 0;
+  for (int q = self->n_quadros - 1; q >= 99 / TAM_PAGINA + 1; q--) {
+    self->quadros_livres[self->n_quadros_livres++] = q;
+  }
+  self->segmentos = NULL;
+  self->n_segmentos = 0;
+  self->semaforos = NULL;
+  self->n_semaforos = 0;
+  self->futexes = NULL;
+  self->n_futexes = 0;
+  self->dormindo = timer_queue_create();
+  self->perfil = perfil_cria(N_FASES, nomes_das_fases);
   return self;
 }
 
 void so_destroi(so_t *self)
 {
   cpu_define_chamaC(self->cpu, NULL, NULL);
+  cpu_define_salvamento(self->cpu, cpu_salva_na_memoria);
+  es_escreve(self->es, D_PIC_MASCARA, 0);
+  console_define_comando(self->console, 'R', NULL, NULL);
+  scheduler_destroy(self->scheduler);
+  process_table_destroy(self->process_table);
+  for (int t = 0; t < N_TERMINAIS; t++) {
+    queue_destroy(self->entradas[t].buffer);
+  }
+  for (int p = 0; p < self->n_pipes; p++) {
+    queue_destroy(self->pipes[p].valores);
+    free(self->pipes[p].escritores);
+  }
+  for (int s = 0; s < self->n_segmentos; s++) {
+    free(self->segmentos[s].quadros);
+  }
+  free(self->segmentos);
+  for (int s = 0; s < self->n_semaforos; s++) {
+    wait_queue_destroy(self->semaforos[s].espera);
+  }
+  free(self->semaforos);
+  for (int f = 0; f < self->n_futexes; f++) {
+    wait_queue_destroy(self->futexes[f].espera);
+  }
+  free(self->futexes);
+  timer_queue_destroy(self->dormindo);
+  perfil_destroi(self->perfil);
+  free(self->ref_quadros);
+  free(self->quadros_livres);
+  free(self->terminados);
+  // não tem mais processos, tabelas de páginas nem filas de espera: a
+  //   memória dos pools pode ser devolvida (um próximo SO cria outros)
+  process_destroy_pool();
+  tabpag_destroi_pools();
+  wait_queue_destroy_pools();
   free(self);
 }
 
@@ -147,6 +359,13 @@ static void so_trata_irq(so_t *self, int irq);
 static void so_trata_pendencias(so_t *self);
 static void so_escalona(so_t *self);
 static int so_despacha(so_t *self);
+static void so_programa_relogio(so_t *self);
+static void so_processo_pronto(so_t *self, Process* proc);
+static void so_desbloqueia(so_t *self, Process* proc);
+static void so_muda_estado(so_t *self, Process* proc, Process_State state);
+static void so_bloqueia(so_t *self, Process* proc, Process_Blocking_On on, int id);
+static void so_registra_termino(so_t *self, Process* proc);
+static int so_agora(so_t *self);
 
 // função a ser chamada pela CPU quando executa a instrução CHAMAC, no tratador de
 //   interrupção em assembly
@@ -168,71 +387,135 @@ static int so_trata_interrupcao(void *argC, int reg_A)
   irq_t irq = reg_A;
   // esse print polui bastante, recomendo tirar quando estiver com mais confiança
   console_printf("SO: recebi IRQ %d (%s)", irq, irq_nome(irq));
+  // cada fase tem o tempo real medido no perfil; a espera ativa não é medida
   // salva o estado da cpu no descritor do processo que foi interrompido
+  perfil_inicia(self->perfil, FASE_SALVA);
   so_salva_estado_da_cpu(self);
+  perfil_termina(self->perfil, FASE_SALVA);
   // faz o atendimento da interrupção
+  perfil_inicia(self->perfil, FASE_TRATA_IRQ);
   so_trata_irq(self, irq);
+  perfil_termina(self->perfil, FASE_TRATA_IRQ);
   // faz o processamento independente da interrupção
+  perfil_inicia(self->perfil, FASE_PENDENCIAS);
   so_trata_pendencias(self);
+  perfil_termina(self->perfil, FASE_PENDENCIAS);
   // escolhe o próximo processo a executar
+  perfil_inicia(self->perfil, FASE_ESCALONA);
   so_escalona(self);
+  perfil_termina(self->perfil, FASE_ESCALONA);
 
   // T1: Se nenhum processo foi escalonado, parte pra espera ativa.
-  while (!self->erro_interno && self->current_process == NO_PROCESS_RUNNING) {
+  // O relógio não anda durante a espera; se tem processo dormindo, a CPU fica
+  //   parada até a interrupção do relógio que vai acordá-lo.
+  while (!self->erro_interno && self->current_process == NULL && !self->terminou
+         && timer_queue_size(self->dormindo) == 0) {
     console_tictac(self->console);
     so_trata_pendencias(self);
     so_escalona(self);
   }
 
-  // recupera o estado do processo escolhido
-  return so_despacha(self);
+  // programa a próxima interrupção do relógio e recupera o estado do
+  //   processo escolhido
+  perfil_inicia(self->perfil, FASE_DESPACHA);
+  so_programa_relogio(self);
+  int ret = so_despacha(self);
+  perfil_termina(self->perfil, FASE_DESPACHA);
+  return ret;
 }
 
 static void so_salva_estado_da_cpu(so_t *self)
 { // T1: Salva o estado da CPU no descritor do processo corrente.
-  if (self->current_process == NO_PROCESS_RUNNING || !self->process_table[self->current_process]) return;
+  if (self->current_process == NULL) return;
+  cpu_contexto_t cpu_ctx;
+  cpu_le_contexto(self->cpu, &cpu_ctx);
+
+  Process_Context* ctx = &self->current_process->context;
+  ctx->pc = cpu_ctx.PC;
+  ctx->a = cpu_ctx.A;
+  ctx->x = cpu_ctx.X;
+  ctx->err = cpu_ctx.erro;
+}
 
-  Process_Context ctx;
-  mmu_le(self->mmu, IRQ_END_PC, &ctx.pc, supervisor);
-  mmu_le(self->mmu, IRQ_END_A, &ctx.a, supervisor);
-  mmu_le(self->mmu, IRQ_END_X, &ctx.x, supervisor);
-  mmu_le(self->mmu, IRQ_END_erro, (int*) &ctx.err, supervisor);
-  self->process_table[self->current_process]->context = ctx;
+// Desliga os pedidos de interrupção dos terminais no controlador.
+static void so_reconhece_terminais(so_t *self)
+{
+  if (es_escreve(self->es, D_PIC_RECONHECE, IRQ_TECLADO) != ERR_OK
+      || es_escreve(self->es, D_PIC_RECONHECE, IRQ_TELA) != ERR_OK) {
+    console_printf("SO: problema no reconhecimento da interrupção");
+    self->erro_interno = true;
+  }
 }
 
 static void so_trata_pendencias(so_t *self)
 { // T1: Trata pendências e contabilidade.
 
-  for (int i = 0; i < MAX_PROCESSES; i++) {
-    Process* proc = self->process_table[i];
-    if (!proc || proc->state != Process_State_BLOCKING) continue;
+  // Os terminais são consultados aqui a cada interrupção, o que atende os
+  //   pedidos de IRQ_TECLADO e IRQ_TELA; o que mudar depois da consulta pede
+  //   uma nova interrupção.
+  so_reconhece_terminais(self);
+
+  // Recolhe o que foi digitado nos terminais.
+  so_le_teclados(self);
+
+  // Envia a saída bufferizada aos terminais que estiverem disponíveis.
+  for (Process* proc = process_table_first(self->process_table); proc; proc = proc->live_next) {
+    so_esvazia_saida(self, proc);
+  }
+
+  // O próximo é obtido antes porque o desbloqueio tira o processo da lista.
+  Process* next = NULL;
+  for (Process* proc = process_table_first_blocked(self->process_table); proc; proc = next) {
+    next = proc->state_next;
 
     switch (proc->blocking.on) {
       case Process_Blocking_On_INPUT: {
-        int state = 0;
-        es_le(self->es, proc->blocking.id, &state);
-        if (state) {
-          process_receive_input(self->es, proc);
-          proc->state = Process_State_READY;
-          proc->blocking.on = Process_Blocking_On_NOT_BLOCKING;
+        if (queue_size(so_entrada_do_processo(self, proc)->buffer) > 0) {
+          so_desbloqueia(self, proc);
+          process_receive_input(self, proc);
         }
       } break;
 
-      case Process_Blocking_On_OUTPUT: {
-        int state = 0;
-        es_le(self->es, proc->blocking.id, &state);
-        if (state) {
-          process_send_output(self->es, proc);
-          proc->state = Process_State_READY;
-          proc->blocking.on = Process_Blocking_On_NOT_BLOCKING;
+      case Process_Blocking_On_PIPE_FULL: {
+        int pipe;
+        if (queue_free(self->pipes[proc->blocking.id].valores) == 0) break;
+        if (so_envia(self, proc, &pipe) && proc->state == Process_State_BLOCKING) {
+          so_desbloqueia(self, proc);
+        }
+      } break;
+
+      case Process_Blocking_On_PIPE_EMPTY: {
+        int pipe;
+        Pipe* p = &self->pipes[proc->blocking.id];
+        if (queue_size(p->valores) == 0 && !so_pipe_no_fim(p)) break;
+        if (so_recebe(self, proc, &pipe) && proc->state == Process_State_BLOCKING) {
+          so_desbloqueia(self, proc);
+        }
+      } break;
+
+      case Process_Blocking_On_INPUT_LINE: {
+        if (so_le_linha(self, proc) && proc->state == Process_State_BLOCKING) {
+          so_desbloqueia(self, proc);
+        }
+      } break;
+
+      case Process_Blocking_On_OUTPUT_BUFFER: {
+        if (queue_free(proc->output) == 0) break;
+        if (proc->blocking.id == SO_ESCR_STR) {
+          // Continua a cópia; só desbloqueia se a string acabou.
+          if (so_escr_str(self, proc) && proc->state == Process_State_BLOCKING) {
+            so_desbloqueia(self, proc);
+          }
+        } else {
+          so_desbloqueia(self, proc);
+          so_escr_bufferizada(self, proc);
         }
       } break;
 
       case Process_Blocking_On_PROCESS: {
-        Process* target = process_table_find(self, proc->blocking.id);
+        Process* target = process_table_find(self->process_table, proc->blocking.id);
         if (target && target->state == Process_State_TERMINATED) {
-          proc->blocking.on = Process_Blocking_On_NOT_BLOCKING;
-          proc->state = Process_State_READY;
+          so_desbloqueia(self, proc);
         }
       } break;
 
@@ -240,67 +523,106 @@ static void so_trata_pendencias(so_t *self)
     }
   }
 
-  for (int i = 0; i < MAX_PROCESSES; i++) {
-    Process* proc = self->process_table[i];
-    if (!proc) continue;
-
-    if (proc->state == Process_State_TERMINATED) {
-      console_printf("SO: Destruindo processo %d\n.", proc->pid);
-      process_destroy(proc);
-      self->process_table[i] = NULL;
-    }
+  // Processos com saída pendente só são destruídos depois que ela for enviada.
+  for (Process* proc = process_table_first_terminated(self->process_table); proc; proc = next) {
+    next = proc->state_next;
+    if (proc->output && queue_size(proc->output) > 0) continue;
+    console_printf("SO: Destruindo processo %d\n.", proc->pid);
+    scheduler_remove(self->scheduler, proc);
+    so_registra_termino(self, proc);
+    if (proc == self->current_process) self->current_process = NULL;
+    // o descritor e a tabela podem ser reaproveitados por um novo processo
+    if (proc->page_table == self->tabpag_despachada) self->tabpag_despachada = NULL;
+    process_table_remove(self->process_table, proc);
+    so_tira_da_espera(self, proc);
+    so_fecha_pipes(self, proc);
+    so_libera_memoria(self, proc);
+    process_destroy(proc);
   }
 }
 
+// Fração do quantum do processo corrente que já foi usada, de 0 a 1.
+static float so_fracao_do_quantum_usada(so_t *self)
+{
+  float used = (float) (so_agora(self) - self->dispatch_time)
+             / (self->quantum_inicial * INTERVALO_INTERRUPCAO);
+  return used > 1 ? 1 : used;
+}
+
 static void so_escalona(so_t *self)
 { // T1: Escolhe o próximo processo a ser executado.
   // Só escalona se o quantum do processo atual terminou ou não existe processo executando.
-  if (self->current_process != NO_PROCESS_RUNNING
-  && self->process_table[self->current_process]
-  && self->process_table[self->current_process]->state == Process_State_RUNNING
-  && self->quantum > 0) return;
-
-  int next_process = (self->current_process + 1) % MAX_PROCESSES;
-  bool found = false;
-  bool remaining = false;
-  for (int i = 0; i < MAX_PROCESSES; i++, next_process = (next_process + 1) % MAX_PROCESSES) {
-    Process* proc = self->process_table[next_process];
-    if (proc) {
-      remaining = true;
-      if (proc->state & (Process_State_READY | Process_State_RUNNING)) {
-        found = true;
-        break;
-      }
+  if (self->current_process
+  && self->current_process->state == Process_State_RUNNING
+  && so_agora(self) < self->fim_do_quantum) return;
+
+  // Avisa o escalonador que o processo corrente está deixando a CPU.
+  Process* previous = self->current_process;
+  if (previous) {
+    float used = so_fracao_do_quantum_usada(self);
+    if (previous->state == Process_State_RUNNING) {
+      previous->stats.preemptions++;
+      scheduler_on_preempt(self->scheduler, previous, used);
+      so_processo_pronto(self, previous);
+    } else if (previous->state == Process_State_BLOCKING) {
+      scheduler_on_block(self->scheduler, previous, used);
     }
   }
 
-  if (!remaining) {
-    console_printf("SO: Não existem mais processos!");
-    // self->erro_interno = true;
+  self->current_process = scheduler_pick(self->scheduler);
+  if (self->current_process) {
+    Process* proc = self->current_process;
+    so_muda_estado(self, proc, Process_State_RUNNING);
+    self->dispatch_time = so_agora(self);
+    if (proc != previous) self->n_trocas_de_contexto++;
+    self->quantum_inicial = scheduler_quantum(self->scheduler, proc);
+    self->fim_do_quantum = self->dispatch_time + self->quantum_inicial * INTERVALO_INTERRUPCAO;
+  } else {
+    if (process_table_size(self->process_table) == 0 && !self->terminou) {
+      console_printf("SO: Não existem mais processos!");
+      self->terminou = true;
+    }
   }
 
-  if (found) {
-    // Se o processo anterior estava em 'Running', vai para 'Ready'.
-    if (self->current_process != NO_PROCESS_RUNNING
-    && self->process_table[self->current_process]) {
-      Process* previous = self->process_table[self->current_process];
-      if (previous->state == Process_State_RUNNING) previous->state = Process_State_READY;
-    }
+  for (Process* proc = process_table_first(self->process_table); proc; proc = proc->live_next)
+    console_printf("[%d, %d]", proc->pid, proc->state);
+  console_printf("\n");
+}
 
-    // Atualiza processo em execução.
-    self->current_process = next_process;
-    self->process_table[self->current_process]->state = Process_State_RUNNING;
-  }
-  else {
-    self->current_process = NO_PROCESS_RUNNING;
-  }
+// Coloca o processo no estado 'Ready', disponível para o escalonador.
+static void so_processo_pronto(so_t *self, Process* proc)
+{
+  so_muda_estado(self, proc, Process_State_READY);
+  scheduler_enqueue(self->scheduler, proc);
+}
 
-  self->quantum = SCHEADULER_QUANTUM;
+// Tira o processo do estado 'Blocking'.
+static void so_desbloqueia(so_t *self, Process* proc)
+{
+  proc->blocking.on = Process_Blocking_On_NOT_BLOCKING;
+  scheduler_on_wake(self->scheduler, proc);
+  so_processo_pronto(self, proc);
+}
 
-  for (int i = 0; i < MAX_PROCESSES; i++)
-    console_printf("[%d, %d]", (self->process_table[i]) ? self->process_table[i]->pid : -1,
-                   (self->process_table[i]) ? self->process_table[i]->state : -1);
-  console_printf("\n");
+static void so_muda_estado(so_t *self, Process* proc, Process_State state)
+{
+  if (proc->state == Process_State_READY) self->n_prontos--;
+  if (state == Process_State_READY) self->n_prontos++;
+  process_set_state(proc, state, so_agora(self));
+  process_table_update(self->process_table, proc);
+}
+
+static void so_bloqueia(so_t *self, Process* proc, Process_Blocking_On on, int id)
+{
+  process_block(proc, on, id, so_agora(self));
+  process_table_update(self->process_table, proc);
+}
+
+static int so_agora(so_t *self)
+{
+  int agora = 0;
+  es_le(self->es, D_RELOGIO_INSTRUCOES, &agora);
+  return agora;
 }
 
 static int so_despacha(so_t *self)
@@ -309,18 +631,192 @@ static int so_despacha(so_t *self)
     console_printf("SO: Erro interno!");
     return self->erro_interno;
   }
-
-  Process* proc = self->process_table[self->current_process];
-  Process_Context ctx = proc->context;
-  mmu_escreve(self->mmu, IRQ_END_PC, ctx.pc, supervisor);
-  mmu_escreve(self->mmu, IRQ_END_A, ctx.a, supervisor);
-  mmu_escreve(self->mmu, IRQ_END_X, ctx.x, supervisor);
+  // Nada para executar, a CPU fica parada até a próxima interrupção.
+  if (self->current_process == NULL) return 1;
+
+  Process* proc = self->current_process;
+  cpu_contexto_t cpu_ctx = {
+    .PC = proc->context.pc,
+    .A = proc->context.a,
+    .X = proc->context.x,
+    .erro = ERR_OK,
+    .complemento = 0,
+    .modo = usuario,
+  };
+  cpu_define_contexto(self->cpu, &cpu_ctx);
   // T2:
-  mmu_define_tabpag(self->mmu, proc->page_table);
+  if (proc->page_table != self->tabpag_despachada) {
+    mmu_define_tabpag(self->mmu, proc->page_table);
+    self->tabpag_despachada = proc->page_table;
+  }
 
   return 0;
 }
 
+// Programa o timer 'timer' para gerar uma interrupção no instante 'prazo'
+//   (-1 desliga o timer).
+static void so_programa_timer(so_t *self, int timer, int prazo)
+{
+  int agora = so_agora(self);
+  int intervalo = 0;
+  if (prazo >= 0) intervalo = prazo > agora ? prazo - agora : 1;
+  dispositivo_id_t disp = D_RELOGIO_TIMER_0 + 3 * timer;
+  if (es_escreve(self->es, disp, intervalo) != ERR_OK) {
+    console_printf("SO: problema na programação do timer %d", timer);
+    self->erro_interno = true;
+  }
+}
+
+// Programa os timers para os próximos instantes em que o SO tem algo a fazer:
+//   o do escalonador para o fim do quantum (se tem outro processo esperando a
+//   CPU), o de sono para o primeiro processo a acordar. Se não tem nada disso,
+//   o processo corrente executa sem interrupções do relógio; quem espera pelos
+//   terminais é atendido pelas interrupções deles.
+static void so_programa_relogio(so_t *self)
+{
+  int prazo = -1;
+  if (self->current_process && self->n_prontos > 0) {
+    prazo = self->fim_do_quantum;
+  }
+  so_programa_timer(self, TIMER_ESCALONADOR, prazo);
+  so_programa_timer(self, TIMER_SONO, timer_queue_next(self->dormindo));
+}
+
+// CONTABILIDADE {{{1
+
+// Guarda a contabilidade do processo que vai ser destruído.
+static void so_registra_termino(so_t *self, Process* proc)
+{
+  int n = self->n_terminados++;
+  self->terminados = realloc(self->terminados, self->n_terminados * sizeof(Finished_Process));
+  assert(self->terminados != NULL);
+  self->terminados[n] = (Finished_Process) { .pid = proc->pid, .stats = proc->stats };
+}
+
+static int so_turnaround(Process_Stats *stats)
+{
+  return stats->termination_time - stats->creation_time;
+}
+
+// Um processo morto antes de executar tem tempo de resposta igual ao turnaround.
+static int so_resposta(Process_Stats *stats)
+{
+  int primeira = stats->first_run_time < 0 ? stats->termination_time : stats->first_run_time;
+  return primeira - stats->creation_time;
+}
+
+static int compara_int(const void *a, const void *b)
+{
+  return *(const int *) a - *(const int *) b;
+}
+
+void so_define_programa_inicial(so_t *self, char *nome)
+{
+  strncpy(self->programa_inicial, nome, sizeof(self->programa_inicial) - 1);
+  self->programa_inicial[sizeof(self->programa_inicial) - 1] = '\0';
+}
+
+bool so_terminou(so_t *self)
+{
+  return self->terminou || self->erro_interno;
+}
+
+char *so_escalonador(so_t *self)
+{
+  return scheduler_name(self->scheduler);
+}
+
+void so_metricas(so_t *self, so_metricas_t *metricas)
+{
+  *metricas = (so_metricas_t) {
+    .n_processos = self->n_terminados,
+    .n_trocas_de_contexto = self->n_trocas_de_contexto,
+  };
+  int n = self->n_terminados;
+  if (n == 0) return;
+
+  int turnarounds[n];
+  long soma_turnaround = 0, soma_resposta = 0, soma_espera = 0;
+  for (int i = 0; i < n; i++) {
+    Process_Stats *stats = &self->terminados[i].stats;
+    turnarounds[i] = so_turnaround(stats);
+    soma_turnaround += turnarounds[i];
+    soma_resposta += so_resposta(stats);
+    soma_espera += stats->ready_time;
+    if (stats->termination_time > metricas->tempo_total) {
+      metricas->tempo_total = stats->termination_time;
+    }
+  }
+  metricas->turnaround_medio = (float) soma_turnaround / n;
+  metricas->resposta_media = (float) soma_resposta / n;
+  metricas->espera_media = (float) soma_espera / n;
+
+  qsort(turnarounds, n, sizeof(int), compara_int);
+  // percentil 95 pelo método do posto mais próximo
+  int posto = (95 * n + 99) / 100;
+  metricas->turnaround_p95 = turnarounds[posto - 1];
+}
+
+static void so_imprime_processo(int pid, Process_Stats *stats, char *estado)
+{
+  // bloqueios por motivo, só os que aconteceram ("sem:3 dorme:1")
+  char bloqueios[160] = "";
+  int n = 0;
+  for (int i = 0; i < PROCESS_BLOCKING_REASONS; i++) {
+    if (stats->blocks[i] == 0) continue;
+    n += snprintf(bloqueios + n, sizeof(bloqueios) - n, " %s:%d",
+                  process_blocking_name(i), stats->blocks[i]);
+    if (n >= (int)sizeof(bloqueios)) break;
+  }
+  console_printf("%4d %-5s %6d %6d %6d %6d %6d %5d %5d%s", pid, estado,
+                 stats->creation_time, stats->termination_time,
+                 stats->ready_time, stats->running_time, stats->blocked_time,
+                 stats->dispatches, stats->preemptions, bloqueios);
+}
+
+void so_imprime_relatorio(void *arg)
+{
+  so_t *self = arg;
+  console_printf("SO: contabilidade (tempos em instruções), escalonador %s",
+                 so_escalonador(self));
+  console_printf(" pid estad   cria    fim pronto   exec   bloq  desp preem bloqueios");
+  for (int i = 0; i < self->n_terminados; i++) {
+    so_imprime_processo(self->terminados[i].pid, &self->terminados[i].stats, "fim");
+  }
+  // Processos vivos: inclui o tempo no estado atual até agora.
+  int agora = so_agora(self);
+  for (Process* proc = process_table_first(self->process_table); proc; proc = proc->live_next) {
+    Process copia = *proc;
+    process_set_state(&copia, proc->state, agora);
+    char *estado = proc->state == Process_State_RUNNING  ? "exec"
+                 : proc->state == Process_State_BLOCKING ? "bloq"
+                 : proc->state == Process_State_READY    ? "pront" : "?";
+    so_imprime_processo(proc->pid, &copia.stats, estado);
+  }
+
+  so_metricas_t m;
+  so_metricas(self, &m);
+  console_printf("SO: %d terminados, %d trocas de contexto, tempo %d", m.n_processos,
+                 m.n_trocas_de_contexto, m.tempo_total);
+  console_printf("SO: turnaround médio %.1f p95 %d, resposta média %.1f, espera média %.1f",
+                 m.turnaround_medio, m.turnaround_p95, m.resposta_media, m.espera_media);
+  console_printf("SO: %ld mensagens da console perdidas no registro até aqui",
+                 console_mensagens_perdidas(self->console));
+
+  // tempo real gasto pelo SO, por fase
+  for (int f = 0; f < N_FASES; f++) {
+    perfil_fase_t fase;
+    perfil_fase(self->perfil, f, &fase);
+    console_printf("SO: %-10s %7ld vezes, %9lld ns (média %lld, máx %lld)", fase.nome,
+                   fase.n, fase.total_ns, fase.n ? fase.total_ns / fase.n : 0, fase.max_ns);
+  }
+}
+
+perfil_t *so_perfil(so_t *self)
+{
+  return self->perfil;
+}
+
 // TRATAMENTO DE UMA IRQ {{{1
 
 // funções auxiliares para tratar cada tipo de interrupção
@@ -346,6 +842,10 @@ static void so_trata_irq(so_t *self, int irq)
     case IRQ_RELOGIO:
       so_trata_irq_relogio(self);
       break;
+    case IRQ_TECLADO:
+    case IRQ_TELA:
+      // reconhecidas e atendidas em so_trata_pendencias
+      break;
     default:
       so_trata_irq_desconhecida(self, irq);
   }
@@ -354,33 +854,30 @@ static void so_trata_irq(so_t *self, int irq)
 // Interrupção gerada uma única vez, quando a CPU inicializa.
 static void so_trata_irq_reset(so_t *self)
 { // T1: Inicializa a tabela de processos com processo para 'init'.
-  memset(self->process_table, 0, sizeof(self->process_table));
-
-  Process* proc = process_create(D_TERM_A_TECLADO, D_TERM_A_TELA);
-  self->current_process = 0;
-  self->process_table[self->current_process] = proc;
+  Process* proc = process_create(D_TERM_A_TECLADO, D_TERM_A_TELA, so_agora(self));
+  self->current_process = NULL;
+  process_table_insert(self->process_table, proc);
 
   // Carrega o programa 'init' na memória.
-  int ender = so_carrega_programa(self, proc, "init.maq");
-  if (ender != 100) {
+  int ender = so_carrega_programa(self, proc, self->programa_inicial);
+  if (ender < 0) {
     console_printf("SO: problema na carga do programa inicial");
     self->erro_interno = true;
     return;
   }
 
-  // TODO: Algo com proc->page_table?
-
   // Vai de 'New' para 'Ready'.
-  proc->state = Process_State_READY;
+  proc->context.pc = ender;
+  so_processo_pronto(self, proc);
 }
 
 static void so_trata_irq_err_cpu(so_t *self)
 { // T1: Obtém código do erro do descritor e mata o processo corrente.
-  if (self->current_process != NO_PROCESS_RUNNING) {
-    Process* ps = self->process_table[self->current_process];
-    err_t err = self->process_table[self->current_process]->context.err;
+  if (self->current_process) {
+    Process* ps = self->current_process;
+    err_t err = ps->context.err;
     console_printf("SO: Erro na CPU: %s", err_nome(err));
-    ps->state = Process_State_TERMINATED;
+    so_muda_estado(self, ps, Process_State_TERMINATED);
   }
 
   self->erro_interno = true;
@@ -389,17 +886,39 @@ static void so_trata_irq_err_cpu(so_t *self)
 // interrupção gerada quando o timer expira
 static void so_trata_irq_relogio(so_t *self)
 {
-  // rearma o interruptor do relógio e reinicializa o timer para a próxima interrupção
-  err_t e1, e2;
-  e1 = es_escreve(self->es, D_RELOGIO_INTERRUPCAO, 0); // desliga o sinalizador de interrupção
-  e2 = es_escreve(self->es, D_RELOGIO_TIMER, INTERVALO_INTERRUPCAO);
-  if (e1 != ERR_OK || e2 != ERR_OK) {
-    console_printf("SO: problema da reinicialização do timer");
+  // reconhece a interrupção no controlador, vê quais timers dispararam, e
+  //   desliga o pedido de interrupção de cada um; os timers são programados
+  //   na saída do SO (so_programa_relogio)
+  if (es_escreve(self->es, D_PIC_RECONHECE, IRQ_RELOGIO) != ERR_OK) {
+    console_printf("SO: problema no reconhecimento da interrupção");
     self->erro_interno = true;
   }
+  bool acordar = false;
+  int timer;
+  while (es_le(self->es, D_RELOGIO_QUAL_TIMER, &timer) == ERR_OK && timer >= 0) {
+    if (es_escreve(self->es, D_RELOGIO_QUAL_TIMER, timer) != ERR_OK) {
+      console_printf("SO: problema da reinicialização do timer");
+      self->erro_interno = true;
+      break;
+    }
+    if (timer == TIMER_SONO) acordar = true;
+  }
 
-  // T1: Decrementa o quantum do processo corrente.
-  self->quantum--;
+  // as interrupções não são mais periódicas; o escalonador recebe os ticks
+  //   que passaram desde a última vez
+  // o fim do quantum é verificado pelo instante, em so_escalona
+  int agora = so_agora(self);
+  int ticks = (agora - self->ultimo_tick) / INTERVALO_INTERRUPCAO;
+  self->ultimo_tick += ticks * INTERVALO_INTERRUPCAO;
+  while (ticks-- > 0) scheduler_on_tick(self->scheduler);
+
+  // acorda os processos cujo instante já chegou; os outros nem são olhados
+  if (!acordar) return;
+  Process* proc;
+  while ((proc = timer_queue_pop_expired(self->dormindo, agora)) != NULL) {
+    proc->context.a = 0;
+    so_desbloqueia(self, proc);
+  }
 }
 
 // foi gerada uma interrupção para a qual o SO não está preparado
@@ -414,6 +933,18 @@ static void so_trata_irq_desconhecida(so_t *self, int irq)
 // funções auxiliares para cada chamada de sistema
 static void so_chamada_le(so_t *self);
 static void so_chamada_escr(so_t *self);
+static void so_chamada_escr_str(so_t *self);
+static void so_chamada_le_linha(so_t *self);
+static void so_chamada_pipe(so_t *self);
+static void so_chamada_envia(so_t *self);
+static void so_chamada_recebe(so_t *self);
+static void so_chamada_shm(so_t *self);
+static void so_chamada_sem_cria(so_t *self);
+static void so_chamada_sem_p(so_t *self);
+static void so_chamada_sem_v(so_t *self);
+static void so_chamada_futex_espera(so_t *self);
+static void so_chamada_futex_acorda(so_t *self);
+static void so_chamada_dorme(so_t *self);
 static void so_chamada_cria_proc(so_t *self);
 static void so_chamada_mata_proc(so_t *self);
 static void so_chamada_espera_proc(so_t *self);
@@ -421,7 +952,7 @@ static void so_chamada_espera_proc(so_t *self);
 static void so_trata_irq_chamada_sistema(so_t *self)
 {
   // a identificação da chamada está no registrador A
-  int id_chamada = self->process_table[self->current_process]->context.a;
+  int id_chamada = self->current_process->context.a;
   console_printf("SO: chamada de sistema %d", id_chamada);
   switch (id_chamada) {
     case SO_LE:
@@ -430,6 +961,42 @@ static void so_trata_irq_chamada_sistema(so_t *self)
     case SO_ESCR:
       so_chamada_escr(self);
       break;
+    case SO_ESCR_STR:
+      so_chamada_escr_str(self);
+      break;
+    case SO_LE_LINHA:
+      so_chamada_le_linha(self);
+      break;
+    case SO_PIPE:
+      so_chamada_pipe(self);
+      break;
+    case SO_ENVIA:
+      so_chamada_envia(self);
+      break;
+    case SO_RECEBE:
+      so_chamada_recebe(self);
+      break;
+    case SO_SHM:
+      so_chamada_shm(self);
+      break;
+    case SO_SEM_CRIA:
+      so_chamada_sem_cria(self);
+      break;
+    case SO_SEM_P:
+      so_chamada_sem_p(self);
+      break;
+    case SO_SEM_V:
+      so_chamada_sem_v(self);
+      break;
+    case SO_FUTEX_ESPERA:
+      so_chamada_futex_espera(self);
+      break;
+    case SO_FUTEX_ACORDA:
+      so_chamada_futex_acorda(self);
+      break;
+    case SO_DORME:
+      so_chamada_dorme(self);
+      break;
     case SO_CRIA_PROC:
       so_chamada_cria_proc(self);
       break;
@@ -443,98 +1010,385 @@ static void so_trata_irq_chamada_sistema(so_t *self)
       console_printf("SO: chamada de sistema desconhecida (%d)", id_chamada);
 
       // T1: Mata o processo.
-      self->process_table[self->current_process]->state = Process_State_TERMINATED;
+      so_muda_estado(self, self->current_process, Process_State_TERMINATED);
 
       self->erro_interno = true;
   }
 }
 
-void process_receive_input(es_t* io, Process* proc)
-{ // Realiza a leitura, assume dispositivo disponível.
-  int data;
-  if (es_le(io, proc->in, &data) == ERR_OK) {
-    proc->context.a = data;
+void process_receive_input(so_t* self, Process* proc)
+{ // Realiza a leitura, assume que o buffer do terminal não está vazio.
+  Entrada_Terminal* entrada = so_entrada_do_processo(self, proc);
+  int data = queue_pop(entrada->buffer);
+  if (data == '\n') entrada->linhas--;
+  proc->context.a = data;
+}
+
+static void so_chamada_le(so_t *self)
+{ // T1: Realiza a leitura se o dispositivo estiver disponível, senão bloqueia o processo.
+  Process* proc = self->current_process;
+
+  // A entrada é lida do teclado pelo SO, e entregue aos processos do buffer.
+  Entrada_Terminal* entrada = so_entrada_do_processo(self, proc);
+  if (entrada == NULL) {
+    so_muda_estado(self, proc, Process_State_TERMINATED);
+    return;
+  }
+  so_le_teclados(self);
+  if (queue_size(entrada->buffer) == 0) {
+    // Nada digitado, bloqueia o processo.
+    so_bloqueia(self, proc, Process_Blocking_On_INPUT, proc->in + 1);
   } else {
-    proc->state = Process_State_TERMINATED;
+    process_receive_input(self, proc);
   }
 }
 
-void process_send_output(es_t* io, Process* proc)
-{ // Realiza a leitura, assume dispositivo disponível.
-  if (es_escreve(io, proc->out, proc->context.x) == ERR_OK) {
-    proc->context.a = 0;
-  } else {
-    proc->state = Process_State_TERMINATED;
+static void so_chamada_le_linha(so_t *self)
+{
+  Process* proc = self->current_process;
+  if (so_entrada_do_processo(self, proc) == NULL) {
+    so_muda_estado(self, proc, Process_State_TERMINATED);
+    return;
+  }
+  so_le_teclados(self);
+  if (!so_le_linha(self, proc)) {
+    so_bloqueia(self, proc, Process_Blocking_On_INPUT_LINE, proc->in);
   }
 }
 
-static void so_chamada_le(so_t *self)
-{ // T1: Realiza a leitura se o dispositivo estiver disponível, senão bloqueia o processo.
-  Process* proc = self->process_table[self->current_process];
-
-  int state;
-  if (es_le(self->es, proc->in + 1, &state) != ERR_OK) {
-    proc->state = Process_State_TERMINATED;
-  } else if (!state) {
-    // Dispositivo indisponível, bloqueia o processo.
-    proc->state = Process_State_BLOCKING;
-    proc->blocking = (Process_Blocking) {
-      .on = Process_Blocking_On_INPUT,
-      .id = proc->in + 1,
-    };
-  } else {
-    // Dispositivo disponível
-    process_receive_input(self->es, proc);
+// Buffer de entrada do terminal do processo, NULL se o processo não lê de
+//   um terminal.
+static Entrada_Terminal* so_entrada_do_processo(so_t *self, Process* proc)
+{
+  int t = proc->in / 4;
+  if (proc->in % 4 != 0 || t < 0 || t >= N_TERMINAIS) return NULL;
+  return &self->entradas[t];
+}
+
+// Passa o que foi digitado em cada terminal para o seu buffer de entrada,
+//   exatamente como foi digitado (as linhas terminam nos '\n' digitados).
+static void so_le_teclados(so_t *self)
+{
+  for (int t = 0; t < N_TERMINAIS; t++) {
+    Entrada_Terminal* entrada = &self->entradas[t];
+    dispositivo_id_t teclado = t * 4;
+    while (queue_free(entrada->buffer) > 0) {
+      int state = 0, ch;
+      if (es_le(self->es, teclado + 1, &state) == ERR_OK && state
+      && es_le(self->es, teclado, &ch) == ERR_OK) {
+        queue_push(entrada->buffer, ch);
+        if (ch == '\n') entrada->linhas++;
+      } else {
+        break;
+      }
+    }
+  }
+}
+
+// Copia uma linha do buffer de entrada do terminal para o vetor em X na
+//   memória do processo, depois da posição com o máximo (ver SO_LE_LINHA).
+// Retorna false se ainda não tem o que entregar: nem linha completa, nem o
+//   máximo de caracteres, nem o buffer cheio. Em caso de erro, mata o processo.
+static bool so_le_linha(so_t *self, Process* proc)
+{
+  Entrada_Terminal* entrada = so_entrada_do_processo(self, proc);
+  int max;
+  if (mmu_le_bloco(self->mmu, proc->page_table, proc->context.x, 1, &max) != 1
+  || max < 0) {
+    console_printf("SO: processo %d leu linha para vetor inválido", proc->pid);
+    so_muda_estado(self, proc, Process_State_TERMINATED);
+    return true;
+  }
+  if (max > TAM_BUFFER_ENTRADA) max = TAM_BUFFER_ENTRADA;
+  if (entrada->linhas == 0 && queue_free(entrada->buffer) > 0
+  && queue_size(entrada->buffer) <= max) {
+    // com só 'max' caracteres não dá para saber se o próximo é o '\n'
+    return false;
   }
+
+  int linha[TAM_BUFFER_ENTRADA + 1];
+  int n = 0;
+  while (n < max && queue_size(entrada->buffer) > 0) {
+    int ch = queue_pop(entrada->buffer);
+    if (ch == '\n') {
+      entrada->linhas--;
+      break;
+    }
+    linha[n++] = ch;
+  }
+  // uma linha com exatamente 'max' caracteres termina no '\n' seguinte
+  if (n == max && queue_size(entrada->buffer) > 0 && queue_peek(entrada->buffer) == '\n') {
+    queue_pop(entrada->buffer);
+    entrada->linhas--;
+  }
+  linha[n] = 0;
+  if (mmu_escreve_bloco(self->mmu, proc->page_table, proc->context.x + 1, n + 1, linha) != n + 1) {
+    console_printf("SO: processo %d leu linha para vetor inválido", proc->pid);
+    so_muda_estado(self, proc, Process_State_TERMINATED);
+    return true;
+  }
+  proc->context.a = n;
+  return true;
 }
 
 static void so_chamada_escr(so_t *self)
-{ // T1: Realiza a escrita se o dispositivo estiver disponível, senão bloqueia o processo.
-  Process* proc = self->process_table[self->current_process];
-
-  int state;
-  if (es_le(self->es, proc->out + 1, &state) != ERR_OK) {
-    proc->state = Process_State_TERMINATED;
-  } else if (!state) {
-    // Dispositivo indisponível, bloqueia o processo.
-    proc->state = Process_State_BLOCKING;
-    proc->blocking = (Process_Blocking) {
-      .on = Process_Blocking_On_OUTPUT,
-      .id = proc->out + 1,
-    };
+{ // T1: Coloca o caractere no buffer de saída do processo, que é enviado ao
+  //   terminal pelo SO quando ele estiver disponível; só bloqueia o processo
+  //   se o buffer estiver cheio.
+  so_escr_bufferizada(self, self->current_process);
+}
+
+static void so_chamada_escr_str(so_t *self)
+{
+  Process* proc = self->current_process;
+  if (!so_escr_str(self, proc)) {
+    so_bloqueia(self, proc, Process_Blocking_On_OUTPUT_BUFFER, SO_ESCR_STR);
+  }
+}
+
+// Coloca o caractere em X no buffer de saída do processo, ou bloqueia o
+//   processo se o buffer estiver cheio.
+static void so_escr_bufferizada(so_t *self, Process* proc)
+{
+  if (queue_push(so_saida_do_processo(self, proc), proc->context.x)) {
+    proc->context.a = 0;
+    so_esvazia_saida(self, proc);
   } else {
-    // Dispositivo disponível
-    process_send_output(self->es, proc);
+    so_bloqueia(self, proc, Process_Blocking_On_OUTPUT_BUFFER, SO_ESCR);
   }
 }
 
+// Copia a string que está em X na memória do processo para o seu buffer de
+//   saída, em blocos do tamanho do espaço livre no buffer.
+// Retorna false se o buffer encheu antes do fim da string; nesse caso X
+//   aponta para o que falta copiar. Em caso de erro, mata o processo.
+static bool so_escr_str(so_t *self, Process* proc)
+{
+  so_saida_do_processo(self, proc);
+
+  int str[TAM_BUFFER_SAIDA];
+  for (;;) {
+    so_esvazia_saida(self, proc);
+    int livre = queue_free(proc->output);
+    if (livre == 0) return false;
+
+    int lidos = mmu_le_bloco(self->mmu, proc->page_table, proc->context.x, livre, str);
+    for (int i = 0; i < lidos; i++) {
+      if (str[i] == 0) {
+        proc->context.a = 0;
+        so_esvazia_saida(self, proc);
+        return true;
+      }
+      queue_push(proc->output, str[i]);
+    }
+    if (lidos < livre) {
+      // A string continua num endereço inválido.
+      console_printf("SO: processo %d escreveu string inválida", proc->pid);
+      so_muda_estado(self, proc, Process_State_TERMINATED);
+      return true;
+    }
+    proc->context.x += lidos;
+  }
+}
+
+// Buffer de saída do processo, criado na primeira escrita.
+static Queue* so_saida_do_processo(so_t *self, Process* proc)
+{
+  if (proc->output == NULL) proc->output = queue_create(TAM_BUFFER_SAIDA);
+  return proc->output;
+}
+
+// Envia o buffer de saída do processo ao seu terminal, enquanto o terminal
+//   aceitar. Chamada a cada interrupção (em so_trata_pendencias), inclusive
+//   as do relógio, e a cada escrita.
+static void so_esvazia_saida(so_t *self, Process* proc)
+{
+  Queue* saida = proc->output;
+  while (saida && queue_size(saida) > 0) {
+    int state;
+    if (es_le(self->es, proc->out + 1, &state) != ERR_OK) {
+      // Dispositivo inválido, a saída é descartada.
+      while (queue_size(saida) > 0) queue_pop(saida);
+      return;
+    }
+    if (!state) return;
+    if (es_escreve(self->es, proc->out, queue_pop(saida)) != ERR_OK) return;
+  }
+}
+
+static void so_chamada_pipe(so_t *self)
+{
+  if (self->n_pipes == N_PIPES) {
+    console_printf("SO: processo %d pediu pipe, mas já existem %d",
+                   self->current_process->pid, N_PIPES);
+    self->current_process->context.a = -1;
+    return;
+  }
+  int n = self->n_pipes++;
+  self->pipes[n] = (Pipe) { .valores = queue_create(TAM_PIPE) };
+  self->current_process->context.a = n;
+}
+
+// Lê o cabeçalho do vetor em X (pipe e número de valores) das chamadas
+//   SO_ENVIA e SO_RECEBE.
+// Retorna o pipe, ou NULL em caso de erro (A recebe o erro ou o processo
+//   é morto).
+static Pipe* so_pipe_da_chamada(so_t *self, Process* proc, int cab[2])
+{
+  if (mmu_le_bloco(self->mmu, proc->page_table, proc->context.x, 2, cab) != 2) {
+    console_printf("SO: processo %d usou vetor inválido para pipe", proc->pid);
+    so_muda_estado(self, proc, Process_State_TERMINATED);
+    return NULL;
+  }
+  if (cab[0] < 0 || cab[0] >= self->n_pipes || cab[1] < 0) {
+    proc->context.a = -1;
+    return NULL;
+  }
+  return &self->pipes[cab[0]];
+}
+
+static void so_chamada_envia(so_t *self)
+{
+  Process* proc = self->current_process;
+  proc->transferred = 0;
+  int pipe;
+  if (!so_envia(self, proc, &pipe)) {
+    so_bloqueia(self, proc, Process_Blocking_On_PIPE_FULL, pipe);
+  }
+}
+
+static void so_chamada_recebe(so_t *self)
+{
+  Process* proc = self->current_process;
+  int pipe;
+  if (!so_recebe(self, proc, &pipe)) {
+    so_bloqueia(self, proc, Process_Blocking_On_PIPE_EMPTY, pipe);
+  }
+}
+
+// O pipe não vai mais receber valores: já teve escritores e todos terminaram.
+static bool so_pipe_no_fim(Pipe* pipe)
+{
+  return pipe->teve_escritor && pipe->n_escritores == 0;
+}
+
+// Registra o processo como escritor do pipe.
+static void so_registra_escritor(Pipe* pipe, Process* proc)
+{
+  for (int i = 0; i < pipe->n_escritores; i++) {
+    if (pipe->escritores[i] == proc->pid) return;
+  }
+  pipe->escritores = realloc(pipe->escritores, (pipe->n_escritores + 1) * sizeof(int));
+  assert(pipe->escritores != NULL);
+  pipe->escritores[pipe->n_escritores++] = proc->pid;
+  pipe->teve_escritor = true;
+}
+
+// Tira o processo (que vai ser destruído) dos escritores dos pipes. Quem
+//   espera por um pipe vazio que ficou sem escritores recebe o fim (A = 0).
+static void so_fecha_pipes(so_t *self, Process* proc)
+{
+  for (int p = 0; p < self->n_pipes; p++) {
+    Pipe* pipe = &self->pipes[p];
+    for (int i = 0; i < pipe->n_escritores; i++) {
+      if (pipe->escritores[i] != proc->pid) continue;
+      pipe->escritores[i] = pipe->escritores[--pipe->n_escritores];
+      break;
+    }
+  }
+  Process* next = NULL;
+  for (Process* leitor = process_table_first_blocked(self->process_table); leitor; leitor = next) {
+    next = leitor->state_next;
+    int pipe;
+    if (leitor->blocking.on == Process_Blocking_On_PIPE_EMPTY
+    && so_recebe(self, leitor, &pipe) && leitor->state == Process_State_BLOCKING) {
+      so_desbloqueia(self, leitor);
+    }
+  }
+}
+
+// Copia para o pipe os valores do vetor em X, a partir de 'transferred'.
+// Retorna false se o pipe encheu antes do fim (o número do pipe vai em *id).
+static bool so_envia(so_t *self, Process* proc, int* id)
+{
+  int cab[2];
+  Pipe* p = so_pipe_da_chamada(self, proc, cab);
+  if (p == NULL) return true;
+  so_registra_escritor(p, proc);
+  Queue* pipe = p->valores;
+
+  int valores[TAM_PIPE];
+  while (proc->transferred < cab[1]) {
+    int n = cab[1] - proc->transferred;
+    if (n > queue_free(pipe)) n = queue_free(pipe);
+    if (n == 0) {
+      *id = cab[0];
+      return false;
+    }
+    int end = proc->context.x + 2 + proc->transferred;
+    if (mmu_le_bloco(self->mmu, proc->page_table, end, n, valores) != n) {
+      console_printf("SO: processo %d usou vetor inválido para pipe", proc->pid);
+      so_muda_estado(self, proc, Process_State_TERMINATED);
+      return true;
+    }
+    for (int i = 0; i < n; i++) queue_push(pipe, valores[i]);
+    proc->transferred += n;
+  }
+  proc->context.a = proc->transferred;
+  return true;
+}
+
+// Copia do pipe para o vetor em X o que estiver disponível.
+// Retorna false se o pipe está vazio e ainda pode receber valores (o número
+//   do pipe vai em *id); vazio e sem escritores, recebe 0 valores (fim).
+static bool so_recebe(so_t *self, Process* proc, int* id)
+{
+  int cab[2];
+  Pipe* p = so_pipe_da_chamada(self, proc, cab);
+  if (p == NULL) return true;
+  Queue* pipe = p->valores;
+
+  int n = cab[1];
+  if (n > queue_size(pipe)) n = queue_size(pipe);
+  if (n == 0 && cab[1] > 0 && !so_pipe_no_fim(p)) {
+    *id = cab[0];
+    return false;
+  }
+  int valores[TAM_PIPE];
+  for (int i = 0; i < n; i++) valores[i] = queue_pop(pipe);
+  if (mmu_escreve_bloco(self->mmu, proc->page_table, proc->context.x + 2, n, valores) != n) {
+    console_printf("SO: processo %d usou vetor inválido para pipe", proc->pid);
+    so_muda_estado(self, proc, Process_State_TERMINATED);
+    return true;
+  }
+  proc->context.a = n;
+  return true;
+}
+
 static void so_chamada_cria_proc(so_t *self)
 { // T1: Cria novo processo.
-  Process* proc = self->process_table[self->current_process];
+  Process* proc = self->current_process;
   int filename_address = proc->context.x;
 
   char filename[256];
   if (!so_copia_str_do_processo(self, 256, filename, filename_address, proc)) goto fail;
 
-  int table_entry = -1;
-  for (int i = 0; i < MAX_PROCESSES; i++) {
-    if (self->process_table[i] == NULL) {
-      table_entry = i;
-    }
-  }
-  if (table_entry == -1) goto fail;
-
-  // Seleciona teclado e tela de A até D dependendo da entrada na tabela de processos.
-  dispositivo_id_t in = (table_entry % 4) * 4;
-  dispositivo_id_t out = in + 2;
-  Process* new_proc = process_create(in, out);
+  // A tabela de processos não tem limite; o terminal (de A até D) é escolhido
+  //   pelo pid, que é o próximo a ser atribuído.
+  Process* new_proc = process_create(D_TERM_A_TECLADO, D_TERM_A_TELA, so_agora(self));
+  new_proc->in = (new_proc->pid % 4) * 4;
+  new_proc->out = new_proc->in + 2;
 
   int program_address = so_carrega_programa(self, new_proc, filename);
-  if (program_address < 0) goto fail;
+  if (program_address < 0) {
+    so_libera_memoria(self, new_proc);
+    process_destroy(new_proc);
+    goto fail;
+  }
 
   new_proc->context.pc = program_address;
-  new_proc->state = Process_State_READY;
-  self->process_table[table_entry] = new_proc;
+  process_table_insert(self->process_table, new_proc);
+  so_processo_pronto(self, new_proc);
 
   proc->context.a = new_proc->pid;
 
@@ -546,39 +1400,37 @@ static void so_chamada_cria_proc(so_t *self)
 
 static void so_chamada_mata_proc(so_t *self)
 { // T1: Mata um processo.
-  Process* proc = self->process_table[self->current_process];
+  Process* proc = self->current_process;
   int pid = proc->context.x;
 
   // Mata a si mesmo.
   if (pid == 0) {
-    proc->state = Process_State_TERMINATED;
+    so_muda_estado(self, proc, Process_State_TERMINATED);
     return;
   }
 
-  Process* target = process_table_find(self, pid);
+  Process* target = process_table_find(self->process_table, pid);
   if (target) {
-    target->state = Process_State_TERMINATED;
+    // Não pode mais ser acordado por quem ele esperava.
+    so_tira_da_espera(self, target);
+    so_muda_estado(self, target, Process_State_TERMINATED);
     proc->context.a = 0;
   } else {
     // Não encontrado na tabela.
-    proc->state = Process_State_TERMINATED;
+    so_muda_estado(self, proc, Process_State_TERMINATED);
   }
 }
 
 static void so_chamada_espera_proc(so_t *self)
 { // T1: Bloqueia o processo corrente até a morte do outro.
-  Process* proc = self->process_table[self->current_process];
-  Process* target = process_table_find(self, proc->context.x);
+  Process* proc = self->current_process;
+  Process* target = process_table_find(self->process_table, proc->context.x);
 
   if (target && target->pid != proc->pid) {
-    proc->state = Process_State_BLOCKING;
-    proc->blocking = (Process_Blocking) {
-      .on = Process_Blocking_On_PROCESS,
-      .id = target->pid,
-    };
+    so_bloqueia(self, proc, Process_Blocking_On_PROCESS, target->pid);
     proc->context.a = 0;
   }  else {
-    proc->state = Process_State_TERMINATED;
+    so_muda_estado(self, proc, Process_State_TERMINATED);
   }
 }
 
@@ -612,23 +1464,6 @@ static int so_carrega_programa(so_t *self, Process* processo,
   return end_carga;
 }
 
-static int so_carrega_programa_na_memoria_secundaria(so_t *self, programa_t *programa)
-{
-  static int pos = 0;
-
-  int end_ini = prog_end_carga(programa);
-  int end_fim = end_ini + prog_tamanho(programa);
-
-  for (int end = end_ini; end < end_fim; end++) {
-    if (mem_escreve(self->mem, end, prog_dado(programa, end)) != ERR_OK) {
-      console_printf("Erro na carga da memória, endereco %d\n", end);
-      return -1;
-    }
-  }
-  console_printf("carregado na memória física, %d-%d", end_ini, end_fim);
-  return end_ini;
-}
-
 static int so_carrega_programa_na_memoria_fisica(so_t *self, programa_t *programa)
 {
   int end_ini = prog_end_carga(programa);
@@ -648,9 +1483,7 @@ static int so_carrega_programa_na_memoria_virtual(so_t *self,
                                                   programa_t *programa,
                                                   Process* processo)
 {
-  // t2: isto tá furado...
-  // está simplesmente lendo para o próximo quadro que nunca foi ocupado,
-  //   nem testa se tem memória disponível
+  // t2: cada página é carregada num quadro livre, não tem carga por demanda
   // com memória virtual, a forma mais simples de implementar a carga de um
   //   programa é carregá-lo para a memória secundária, e mapear todas as páginas
   //   da tabela de páginas do processo como inválidas. Assim, as páginas serão
@@ -661,31 +1494,329 @@ static int so_carrega_programa_na_memoria_virtual(so_t *self,
   int end_virt_fim = end_virt_ini + prog_tamanho(programa) - 1;
   int pagina_ini = end_virt_ini / TAM_PAGINA;
   int pagina_fim = end_virt_fim / TAM_PAGINA;
-  int quadro_ini = self->quadro_livre;
-  // mapeia as páginas nos quadros
-  int quadro = quadro_ini;
+  // mapeia as páginas em quadros livres (se faltar memória, os quadros já
+  //   alocados são liberados com o processo)
   for (int pagina = pagina_ini; pagina <= pagina_fim; pagina++) {
-    //tabpag_define_quadro(self->tabpag_global, pagina, quadro);
-    quadro++;
-  }
-  self->quadro_livre = quadro;
-
-  // carrega o programa na memória principal
-  int end_fis_ini = quadro_ini * TAM_PAGINA;
-  int end_fis = end_fis_ini;
-  for (int end_virt = end_virt_ini; end_virt <= end_virt_fim; end_virt++) {
-    if (mem_escreve(self->mem, end_fis, prog_dado(programa, end_virt)) != ERR_OK) {
-      console_printf("Erro na carga da memória, end virt %d fís %d\n", end_virt,
-                     end_fis);
+    int quadro = so_aloca_quadro(self);
+    if (quadro < 0) {
+      console_printf("SO: memória insuficiente para a carga");
       return -1;
     }
-    end_fis++;
+    tabpag_define_quadro(processo->page_table, pagina, quadro);
+  }
+
+  // carrega o programa na memória principal, pela tabela do processo
+  int tam = end_virt_fim - end_virt_ini + 1;
+  int *dados = malloc(tam * sizeof(int));
+  assert(dados != NULL);
+  for (int i = 0; i < tam; i++) {
+    dados[i] = prog_dado(programa, end_virt_ini + i);
+  }
+  int carregados = mmu_escreve_bloco(self->mmu, processo->page_table,
+                                     end_virt_ini, tam, dados);
+  free(dados);
+  if (carregados != tam) {
+    console_printf("Erro na carga da memória, end virt %d\n",
+                   end_virt_ini + carregados);
+    return -1;
   }
-  console_printf("carregado na memória virtual V%d-%d F%d-%d",
-                 end_virt_ini, end_virt_fim, end_fis_ini, end_fis - 1);
+  console_printf("carregado na memória virtual V%d-%d, páginas %d-%d",
+                 end_virt_ini, end_virt_fim, pagina_ini, pagina_fim);
   return end_virt_ini;
 }
 
+// QUADROS E MEMÓRIA COMPARTILHADA {{{1
+
+// retorna um quadro livre com uma referência, ou -1 se não tiver
+static int so_aloca_quadro(so_t *self)
+{
+  if (self->n_quadros_livres == 0) return -1;
+  int quadro = self->quadros_livres[--self->n_quadros_livres];
+  self->ref_quadros[quadro] = 1;
+  return quadro;
+}
+
+// retira uma referência do quadro, que fica livre se era a última
+static void so_libera_quadro(so_t *self, int quadro)
+{
+  assert(self->ref_quadros[quadro] > 0);
+  self->ref_quadros[quadro]--;
+  if (self->ref_quadros[quadro] == 0) {
+    self->quadros_livres[self->n_quadros_livres++] = quadro;
+  }
+}
+
+static void so_destroi_segmentos_sem_uso(so_t *self);
+
+// libera os quadros mapeados pelo processo; os segmentos compartilhados que
+//   não são mais mapeados por nenhum processo são destruídos
+static void so_libera_memoria(so_t *self, Process* proc)
+{
+  int n_paginas = tabpag_tam(proc->page_table);
+  for (int pagina = 0; pagina < n_paginas; pagina++) {
+    int quadro;
+    if (tabpag_traduz(proc->page_table, pagina, &quadro) == ERR_OK) {
+      so_libera_quadro(self, quadro);
+      tabpag_invalida_pagina(proc->page_table, pagina);
+    }
+  }
+  so_destroi_segmentos_sem_uso(self);
+}
+
+// destrói os segmentos compartilhados que não estão mapeados em nenhum processo
+static void so_destroi_segmentos_sem_uso(so_t *self)
+{
+  int s = 0;
+  while (s < self->n_segmentos) {
+    Segmento* seg = &self->segmentos[s];
+    // só resta a referência do próprio segmento
+    if (self->ref_quadros[seg->quadros[0]] > 1) {
+      s++;
+      continue;
+    }
+    console_printf("SO: destruindo segmento '%s'", seg->nome);
+    for (int i = 0; i < seg->n_quadros; i++) {
+      so_libera_quadro(self, seg->quadros[i]);
+    }
+    free(seg->quadros);
+    self->segmentos[s] = self->segmentos[--self->n_segmentos];
+  }
+}
+
+// retorna o segmento com o nome, criando com 'tam' valores se não existir;
+//   retorna NULL se não tiver memória
+static Segmento* so_segmento(so_t *self, char *nome, int tam)
+{
+  for (int s = 0; s < self->n_segmentos; s++) {
+    if (strcmp(self->segmentos[s].nome, nome) == 0) return &self->segmentos[s];
+  }
+
+  int n_quadros = (tam + TAM_PAGINA - 1) / TAM_PAGINA;
+  if (n_quadros < 1 || n_quadros > self->n_quadros_livres) return NULL;
+  Segmento seg = { .n_quadros = n_quadros, .quadros = malloc(n_quadros * sizeof(int)) };
+  assert(seg.quadros != NULL);
+  strcpy(seg.nome, nome);
+  for (int i = 0; i < n_quadros; i++) {
+    seg.quadros[i] = so_aloca_quadro(self);
+    for (int d = 0; d < TAM_PAGINA; d++) {
+      mem_escreve(self->mem, seg.quadros[i] * TAM_PAGINA + d, 0);
+    }
+  }
+
+  self->segmentos = realloc(self->segmentos, (self->n_segmentos + 1) * sizeof(Segmento));
+  assert(self->segmentos != NULL);
+  self->segmentos[self->n_segmentos] = seg;
+  console_printf("SO: criado segmento '%s' com %d quadros", nome, n_quadros);
+  return &self->segmentos[self->n_segmentos++];
+}
+
+static void so_chamada_shm(so_t *self)
+{
+  Process* proc = self->current_process;
+  int cab[2];
+  char nome[TAM_NOME_SEGMENTO];
+  if (mmu_le_bloco(self->mmu, proc->page_table, proc->context.x, 2, cab) != 2
+  || !so_copia_str_do_processo(self, TAM_NOME_SEGMENTO, nome, proc->context.x + 2, proc)
+  || cab[0] < 0 || cab[0] % TAM_PAGINA != 0) {
+    proc->context.a = -1;
+    return;
+  }
+
+  Segmento* seg = so_segmento(self, nome, cab[1]);
+  if (seg == NULL) {
+    proc->context.a = -1;
+    return;
+  }
+  // as páginas onde o segmento vai ser mapeado têm que estar livres
+  int pagina_ini = cab[0] / TAM_PAGINA;
+  for (int i = 0; i < seg->n_quadros; i++) {
+    int quadro;
+    if (tabpag_traduz(proc->page_table, pagina_ini + i, &quadro) == ERR_OK) {
+      proc->context.a = -1;
+      // o segmento pode ter sido criado agora, sem ninguém mapear
+      so_destroi_segmentos_sem_uso(self);
+      return;
+    }
+  }
+  for (int i = 0; i < seg->n_quadros; i++) {
+    tabpag_define_quadro(proc->page_table, pagina_ini + i, seg->quadros[i]);
+    self->ref_quadros[seg->quadros[i]]++;
+  }
+  proc->context.a = 0;
+}
+
+// SEMÁFOROS E FUTEXES {{{1
+
+// Os processos bloqueados em semáforos e futexes não são vistos por
+//   so_trata_pendencias, são acordados diretamente pela chamada V ou ACORDA.
+
+static void so_chamada_sem_cria(so_t *self)
+{
+  Process* proc = self->current_process;
+  if (proc->context.x < 0) {
+    proc->context.a = -1;
+    return;
+  }
+  int n = self->n_semaforos++;
+  self->semaforos = realloc(self->semaforos, self->n_semaforos * sizeof(Semaforo));
+  assert(self->semaforos != NULL);
+  self->semaforos[n] = (Semaforo) { .valor = proc->context.x, .espera = wait_queue_create() };
+  proc->context.a = n;
+}
+
+// semáforo com o número em X, ou NULL (e erro em A) se não existir
+static Semaforo* so_semaforo_da_chamada(so_t *self, Process* proc)
+{
+  int s = proc->context.x;
+  if (s < 0 || s >= self->n_semaforos) {
+    proc->context.a = -1;
+    return NULL;
+  }
+  return &self->semaforos[s];
+}
+
+static void so_chamada_sem_p(so_t *self)
+{
+  Process* proc = self->current_process;
+  Semaforo* sem = so_semaforo_da_chamada(self, proc);
+  if (sem == NULL) return;
+
+  proc->context.a = 0;
+  if (sem->valor > 0) {
+    sem->valor--;
+  } else {
+    wait_queue_push(sem->espera, proc);
+    so_bloqueia(self, proc, Process_Blocking_On_SEMAPHORE, proc->context.x);
+  }
+}
+
+static void so_chamada_sem_v(so_t *self)
+{
+  Process* proc = self->current_process;
+  Semaforo* sem = so_semaforo_da_chamada(self, proc);
+  if (sem == NULL) return;
+
+  proc->context.a = 0;
+  // o processo acordado fica com a unidade, o valor não muda
+  Process* acordado = wait_queue_pop(sem->espera);
+  if (acordado) {
+    so_desbloqueia(self, acordado);
+  } else {
+    sem->valor++;
+  }
+}
+
+// lê o vetor [endereço, valor] em X e traduz o endereço para físico
+// retorna false (e erro em A) se não for possível
+static bool so_futex_da_chamada(so_t *self, Process* proc, int *pendfis, int *pvalor)
+{
+  int cab[2];
+  int quadro;
+  if (mmu_le_bloco(self->mmu, proc->page_table, proc->context.x, 2, cab) != 2
+  || cab[0] < 0
+  || tabpag_traduz(proc->page_table, cab[0] / TAM_PAGINA, &quadro) != ERR_OK) {
+    proc->context.a = -1;
+    return false;
+  }
+  *pendfis = quadro * TAM_PAGINA + cab[0] % TAM_PAGINA;
+  *pvalor = cab[1];
+  return true;
+}
+
+// índice do futex no endereço físico, ou -1 se ninguém espera nele
+static int so_futex(so_t *self, int endfis)
+{
+  for (int f = 0; f < self->n_futexes; f++) {
+    if (self->futexes[f].endereco == endfis) return f;
+  }
+  return -1;
+}
+
+// remove o futex 'f' se não tem mais processos esperando
+static void so_futex_remove_se_vazio(so_t *self, int f)
+{
+  if (wait_queue_size(self->futexes[f].espera) > 0) return;
+  wait_queue_destroy(self->futexes[f].espera);
+  self->futexes[f] = self->futexes[--self->n_futexes];
+}
+
+static void so_chamada_futex_espera(so_t *self)
+{
+  Process* proc = self->current_process;
+  int endfis, esperado, atual;
+  if (!so_futex_da_chamada(self, proc, &endfis, &esperado)) return;
+  mem_le(self->mem, endfis, &atual);
+  if (atual != esperado) {
+    proc->context.a = 1;
+    return;
+  }
+
+  int f = so_futex(self, endfis);
+  if (f < 0) {
+    f = self->n_futexes++;
+    self->futexes = realloc(self->futexes, self->n_futexes * sizeof(Futex));
+    assert(self->futexes != NULL);
+    self->futexes[f] = (Futex) { .endereco = endfis, .espera = wait_queue_create() };
+  }
+  wait_queue_push(self->futexes[f].espera, proc);
+  proc->context.a = 0;
+  so_bloqueia(self, proc, Process_Blocking_On_FUTEX, endfis);
+}
+
+static void so_chamada_futex_acorda(so_t *self)
+{
+  Process* proc = self->current_process;
+  int endfis, max;
+  if (!so_futex_da_chamada(self, proc, &endfis, &max)) return;
+
+  int acordados = 0;
+  int f = so_futex(self, endfis);
+  if (f >= 0) {
+    while (acordados < max) {
+      Process* acordado = wait_queue_pop(self->futexes[f].espera);
+      if (acordado == NULL) break;
+      so_desbloqueia(self, acordado);
+      acordados++;
+    }
+    so_futex_remove_se_vazio(self, f);
+  }
+  proc->context.a = acordados;
+}
+
+static void so_chamada_dorme(so_t *self)
+{
+  Process* proc = self->current_process;
+  int duracao = proc->context.x;
+
+  proc->context.a = 0;
+  if (duracao <= 0) return;
+  // quem acorda é a interrupção do relógio (so_trata_irq_relogio)
+  timer_queue_push(self->dormindo, proc, so_agora(self) + duracao);
+  so_bloqueia(self, proc, Process_Blocking_On_SLEEP, 0);
+}
+
+// tira das filas de espera um processo que vai ser destruído (pode ter sido
+//   morto enquanto esperava)
+static void so_tira_da_espera(so_t *self, Process* proc)
+{
+  int id = proc->blocking.id;
+  switch (proc->blocking.on) {
+    case Process_Blocking_On_SEMAPHORE:
+      wait_queue_remove(self->semaforos[id].espera, proc);
+      break;
+    case Process_Blocking_On_FUTEX: {
+      int f = so_futex(self, id);
+      if (f < 0) break;
+      wait_queue_remove(self->futexes[f].espera, proc);
+      so_futex_remove_se_vazio(self, f);
+    } break;
+    case Process_Blocking_On_SLEEP:
+      timer_queue_remove(self->dormindo, proc);
+      break;
+    default: break;
+  }
+}
+
 // ACESSO À MEMÓRIA DOS PROCESSOS {{{1
 
 // copia uma string da memória do processo para o vetor str.
@@ -717,12 +1848,4 @@ static bool so_copia_str_do_processo(so_t *self, int tam, char str[tam],
   return false;
 }
 
-Process* process_table_find(so_t* os, int pid) {
-  for (int i = 0; i < MAX_PROCESSES; i++) {
-    Process* proc = os->process_table[i];
-    if (proc && proc->pid == pid) return proc;
-  }
-  return NULL;
-}
-
 // vim: foldmethod=marker
@@ -13,11 +13,51 @@ typedef struct so_t so_t;
 #include "cpu.h"
 #include "es.h"
 #include "console.h" // só para uma gambiarra
+#include "perfil.h"
 
+#include <stdbool.h>
+
+// cria o SO, usando a política de escalonamento de nome 'escalonador'
+//   (ver scheduler.c); retorna NULL se essa política não existir
 so_t *so_cria(cpu_t *cpu, mem_t *mem, mem_t* mem_secundaria, mmu_t *mmu,
-              es_t *es, console_t *console);
+              es_t *es, console_t *console, char *escalonador);
 void so_destroi(so_t *self);
 
+// define o arquivo com o programa executado pelo processo inicial (o padrão
+//   é "init.maq"); tem que ser chamada antes da CPU começar a executar
+void so_define_programa_inicial(so_t *self, char *nome);
+
+// retorna true se não existem mais processos (ou o SO parou por erro interno)
+bool so_terminou(so_t *self);
+
+// nome da política de escalonamento em uso
+char *so_escalonador(so_t *self);
+
+// métricas da execução, para comparar políticas de escalonamento
+// os tempos são em instruções executadas, e só consideram processos que
+//   já terminaram
+typedef struct {
+  int n_processos;           // número de processos que terminaram
+  int tempo_total;           // instante em que terminou o último processo
+  int n_trocas_de_contexto;  // vezes em que a CPU passou a outro processo
+  float turnaround_medio;    // tempo entre criação e término
+  int turnaround_p95;
+  float resposta_media;      // tempo entre criação e primeira execução
+  float espera_media;        // tempo no estado pronto
+} so_metricas_t;
+
+void so_metricas(so_t *self, so_metricas_t *metricas);
+
+// imprime na console a contabilidade de cada processo (os que já terminaram
+//   e os que existem) e do sistema
+// também é executada pelo comando 'R' do operador na console
+// recebe um ponteiro para o SO (void *, para poder ser usada como comando)
+void so_imprime_relatorio(void *self);
+
+// tempo real gasto pelo SO em cada fase do tratamento de interrupção (ver
+//   perfil.h); o perfil pertence ao SO
+perfil_t *so_perfil(so_t *self);
+
 // Chamadas de sistema
 // Uma chamada de sistema é realizada colocando a identificação da
 //   chamada (um dos valores abaixo) no registrador A e executando a
@@ -41,6 +81,112 @@ void so_destroi(so_t *self);
 // retorna em A: 0 se OK ou um código de erro negativo
 #define SO_ESCR        2
 
+// escreve uma string no dispositivo de saída do processo
+// recebe em X o endereço do início da string, terminada por um valor 0
+// os caracteres são copiados para um buffer do SO, que os envia ao
+//   dispositivo quando ele estiver disponível; o processo só é bloqueado
+//   se o buffer encher antes do fim da string (nesse caso, X é alterado)
+// retorna em A: 0 se OK ou um código de erro negativo
+#define SO_ESCR_STR   10
+
+// lê uma linha do dispositivo de entrada do processo
+// recebe em X o endereço de um vetor na memória do processo, cuja primeira
+//   posição contém o número máximo de caracteres a ler (n); essa posição não
+//   é alterada, e o vetor deve ter espaço para mais n+1 valores
+// a linha (sem o '\n') é colocada no vetor a partir de X+1, terminada por 0
+// uma linha termina com um '\n' digitado; se tiver exatamente n caracteres,
+//   o '\n' também é consumido; se for maior, ela é dividida: a leitura
+//   retorna os n primeiros, e o restante fica para a próxima leitura (não
+//   dá para distinguir um pedaço de uma linha completa de n caracteres)
+// bloqueia o processo até existir uma linha completa, ou mais de n caracteres, ou
+//   o buffer de entrada do terminal encher
+// retorna em A: o número de caracteres lidos ou um código de erro negativo
+#define SO_LE_LINHA   11
+
+// Chamadas para comunicação entre processos
+// Um pipe é um buffer do SO com capacidade limitada, onde processos enviam
+//   e de onde recebem valores, na ordem em que foram enviados. Os pipes
+//   são numerados a partir de 0, na ordem de criação, e qualquer processo
+//   pode usar qualquer pipe.
+// As chamadas de envio e recebimento recebem em X o endereço de um vetor
+//   na memória do processo: a primeira posição contém o número do pipe, a
+//   segunda o número de valores, e os valores ficam a partir da terceira.
+
+// cria um pipe
+// o número de pipes é limitado, e um pipe existe até o fim do SO
+// retorna em A: o número do pipe criado ou um código de erro negativo (já
+//   existe o número máximo de pipes)
+#define SO_PIPE       12
+
+// envia os valores do vetor em X ao pipe
+// bloqueia o processo enquanto o pipe estiver cheio, até enviar todos
+// retorna em A: o número de valores enviados ou um código de erro negativo
+#define SO_ENVIA      13
+
+// recebe do pipe até o número de valores da segunda posição do vetor em X
+// bloqueia o processo enquanto o pipe estiver vazio
+// um processo que enviou ao pipe é um escritor dele até ser destruído;
+//   quando o pipe fica vazio depois de todos os escritores terem terminado,
+//   é o fim: quem espera é desbloqueado e a chamada retorna 0
+// retorna em A: o número de valores recebidos (colocados no vetor a partir
+//   da terceira posição) ou um código de erro negativo
+#define SO_RECEBE     14
+
+// mapeia um segmento de memória compartilhada na memória do processo
+// recebe em X o endereço de um vetor: a primeira posição contém o endereço
+//   virtual onde o segmento será mapeado (múltiplo do tamanho da página), a
+//   segunda o tamanho do segmento, e a partir da terceira está o nome do
+//   segmento (uma string terminada por 0)
+// se ainda não existir segmento com esse nome, ele é criado com o tamanho
+//   pedido e zerado; se já existir, é mapeado com o tamanho que tem
+// os processos que mapearem o mesmo segmento acessam a mesma memória; o
+//   segmento deixa de existir quando termina o último processo que o mapeou
+// retorna em A: 0 se OK ou um código de erro negativo (nome inválido,
+//   endereço não alinhado ou já ocupado, falta de memória)
+#define SO_SHM        15
+
+// Chamadas para sincronização
+// Semáforos são numerados a partir de 0, na ordem de criação.
+// Um futex é uma posição de memória (normalmente num segmento compartilhado,
+//   ver SO_SHM) onde processos esperam; processos que mapearam o mesmo
+//   segmento em endereços diferentes esperam no mesmo futex.
+
+// cria um semáforo
+// recebe em X o valor inicial
+// retorna em A: o número do semáforo ou um código de erro negativo
+#define SO_SEM_CRIA   16
+
+// operação P (down) no semáforo
+// recebe em X o número do semáforo
+// bloqueia o processo se o valor do semáforo for 0
+// retorna em A: 0 se OK ou um código de erro negativo
+#define SO_SEM_P      17
+
+// operação V (up) no semáforo; acorda um processo esperando, se tiver
+// recebe em X o número do semáforo
+// retorna em A: 0 se OK ou um código de erro negativo
+#define SO_SEM_V      18
+
+// espera num futex
+// recebe em X o endereço de um vetor: a primeira posição contém o endereço
+//   do futex, a segunda o valor esperado
+// se o valor no endereço do futex for o esperado, bloqueia o processo até
+//   ser acordado por SO_FUTEX_ACORDA; senão retorna sem bloquear
+// retorna em A: 0 se bloqueou, 1 se o valor era outro, ou um código de erro
+//   negativo
+#define SO_FUTEX_ESPERA 19
+
+// acorda processos esperando num futex
+// recebe em X o endereço de um vetor: a primeira posição contém o endereço
+//   do futex, a segunda o número máximo de processos a acordar
+// retorna em A: o número de processos acordados ou um código de erro negativo
+#define SO_FUTEX_ACORDA 20
+
+// suspende o processo por um tempo
+// recebe em X o número de instruções que o processo deve ficar sem executar
+// retorna em A: 0
+#define SO_DORME       21
+
 // #define SO_ABRE        3
 // #define SO_FECHA       4
 // #define SO_SEL_LE      5
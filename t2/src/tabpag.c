@@ -4,9 +4,20 @@
 // so24b
 
 #include "tabpag.h"
+#include "pool.h"
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 
+// As tabelas e seus vetores de descritores são criadas e destruídas a cada
+//   processo, então vêm de pools (ver pool.h) em vez de malloc.
+// Os vetores têm capacidade em potências de 2, de TABPAG_MENOR_VETOR até
+//   TABPAG_MENOR_VETOR << (TABPAG_N_CLASSES - 1) descritores, um pool para
+//   cada capacidade; vetores maiores que isso usam malloc.
+#define TABPAG_MENOR_VETOR 8
+#define TABPAG_N_CLASSES 8
+#define TABPAG_OBJETOS_POR_BLOCO 8
+
 // estrutura auxiliar, contém informação sobre uma página
 typedef struct {
   // quadro da memória principal correspondente à página
@@ -26,22 +37,82 @@ struct tabpag_t {
   // o último descritor do vetor sempre contém uma página válida
   // pode ser NULL (se tam_tab == 0)
   descritor_t *tabela;
+  // número de descritores que cabem em 'tabela' (0 se NULL)
+  int cap_tab;
 };
 
+static Pool *tabpag__pool = NULL;
+static Pool *tabpag__pool_vetor[TABPAG_N_CLASSES];
+
+// classe (índice em tabpag__pool_vetor) de um vetor com capacidade 'cap',
+//   ou -1 se não for de nenhum pool
+static int tabpag__classe(int cap)
+{
+  int classe = 0;
+  for (int c = TABPAG_MENOR_VETOR; c < cap; c *= 2) {
+    classe++;
+  }
+  if (classe >= TABPAG_N_CLASSES) return -1;
+  return classe;
+}
+
+// aloca um vetor com pelo menos 'tam' descritores; retorna sua capacidade em *pcap
+static descritor_t *tabpag__aloca_vetor(int tam, int *pcap)
+{
+  int cap = TABPAG_MENOR_VETOR;
+  while (cap < tam) cap *= 2;
+  *pcap = cap;
+  int classe = tabpag__classe(cap);
+  if (classe < 0) {
+    descritor_t *vetor = malloc(cap * sizeof(descritor_t));
+    assert(vetor != NULL);
+    return vetor;
+  }
+  if (tabpag__pool_vetor[classe] == NULL) {
+    tabpag__pool_vetor[classe] = pool_create(cap * sizeof(descritor_t),
+                                             TABPAG_OBJETOS_POR_BLOCO);
+  }
+  return pool_alloc(tabpag__pool_vetor[classe]);
+}
+
+static void tabpag__libera_vetor(descritor_t *vetor, int cap)
+{
+  if (vetor == NULL) return;
+  int classe = tabpag__classe(cap);
+  if (classe < 0) {
+    free(vetor);
+  } else {
+    pool_free(tabpag__pool_vetor[classe], vetor);
+  }
+}
+
 tabpag_t *tabpag_cria(void)
 {
-  tabpag_t *self = malloc(sizeof(*self));
-  assert(self != NULL);
+  if (tabpag__pool == NULL) {
+    tabpag__pool = pool_create(sizeof(tabpag_t), TABPAG_OBJETOS_POR_BLOCO);
+  }
+  tabpag_t *self = pool_alloc(tabpag__pool);
   self->tam_tab = 0;
   self->tabela = NULL;
+  self->cap_tab = 0;
   return self;
 }
 
 void tabpag_destroi(tabpag_t *self)
 {
   if (self != NULL) {
-    if (self->tabela != NULL) free(self->tabela);
-    free(self);
+    tabpag__libera_vetor(self->tabela, self->cap_tab);
+    pool_free(tabpag__pool, self);
+  }
+}
+
+void tabpag_destroi_pools(void)
+{
+  if (tabpag__pool != NULL) pool_destroy(tabpag__pool);
+  tabpag__pool = NULL;
+  for (int c = 0; c < TABPAG_N_CLASSES; c++) {
+    if (tabpag__pool_vetor[c] != NULL) pool_destroy(tabpag__pool_vetor[c]);
+    tabpag__pool_vetor[c] = NULL;
   }
 }
 
@@ -62,16 +133,10 @@ void tabpag_invalida_pagina(tabpag_t *self, int pagina)
     return;
   }
   // última página na tabela -- reduz a tabela até que a última seja válida
+  //   (o vetor não é diminuído, a capacidade continua disponível)
   do {
     self->tam_tab--;
   } while (self->tam_tab > 0 && !self->tabela[self->tam_tab - 1].valida);
-  if (self->tam_tab == 0) {
-    free(self->tabela);
-    self->tabela = NULL;
-  } else {
-    self->tabela = realloc(self->tabela, self->tam_tab * sizeof(descritor_t));
-    assert(self->tabela != NULL);
-  }
 }
 
 // aumenta a tabela, se necessário, para que contenha 'pagina'
@@ -79,12 +144,16 @@ static void tabpag__insere_pagina(tabpag_t *self, int pagina)
 {
   if (pagina < self->tam_tab) return;
   int novo_tam = pagina + 1;
-  if (self->tam_tab == 0) {
-    self->tabela = malloc(novo_tam * sizeof(descritor_t));
-  } else {
-    self->tabela = realloc(self->tabela, novo_tam * sizeof(descritor_t));
+  if (novo_tam > self->cap_tab) {
+    int nova_cap;
+    descritor_t *nova = tabpag__aloca_vetor(novo_tam, &nova_cap);
+    if (self->tam_tab > 0) {
+      memcpy(nova, self->tabela, self->tam_tab * sizeof(descritor_t));
+    }
+    tabpag__libera_vetor(self->tabela, self->cap_tab);
+    self->tabela = nova;
+    self->cap_tab = nova_cap;
   }
-  assert(self->tabela != NULL);
   // marca as páginas inseridas como não válidas
   while (self->tam_tab < novo_tam) {
     self->tabela[self->tam_tab].valida = false;
@@ -135,3 +204,8 @@ err_t tabpag_traduz(tabpag_t *self, int pagina, int *pquadro)
   *pquadro = self->tabela[pagina].quadro;
   return ERR_OK;
 }
+
+int tabpag_tam(tabpag_t *self)
+{
+  return self->tam_tab;
+}
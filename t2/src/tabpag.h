@@ -29,6 +29,11 @@ tabpag_t *tabpag_cria(void);
 // nenhuma outra operação pode ser realizada na tabela após esta chamada
 void tabpag_destroi(tabpag_t *self);
 
+// libera a memória dos pools de onde vêm as tabelas e seus vetores
+// só pode ser chamada quando nenhuma tabela existe (o SO chama ao ser
+//   destruído); a próxima tabela criada recria os pools
+void tabpag_destroi_pools(void);
+
 // define que a tradução da página 'pagina' deve resultar no quadro 'quadro'
 // essa página é marcada como válida, e os bits de acesso e alteração para essa
 //   página são zerados
@@ -61,4 +66,8 @@ bool tabpag_bit_alteracao(tabpag_t *self, int pagina);
 // retorna ERR_PAG_AUSENTE (e não altera '*pquadro') se a página for inválida
 err_t tabpag_traduz(tabpag_t *self, int pagina, int *pquadro);
 
+// retorna o número de páginas na tabela; as páginas a partir desse número
+//   são inválidas (as anteriores podem ser válidas ou não)
+int tabpag_tam(tabpag_t *self);
+
 #endif // TABPAG_H
@@ -6,6 +6,8 @@
 #ifndef TELA_H
 #define TELA_H
 
+#include <stdbool.h>
+
 // identificação da cor para cada parte
 // essa definição deveria ser da console, mas tou com preguiça de refatorar isso
 #define COR_TXT_PAR      1
@@ -20,6 +22,10 @@
 // inicializa o uso da tela
 void tela_init(void);
 
+// retorna false se não existe tela de verdade (tela_nula.c): nada do que é
+//   desenhado aparece, e o operador não digita nada
+bool tela_existe(void);
+
 // finaliza o uso da tela
 void tela_fim();
 
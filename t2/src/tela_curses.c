@@ -29,6 +29,11 @@ void tela_init(void)
   init_pair(COR_OCUPADO,      COLOR_BLACK,  COLOR_RED   );
 }
 
+bool tela_existe(void)
+{
+  return true;
+}
+
 void tela_fim()
 {
   // acaba com o curses
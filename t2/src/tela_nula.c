@@ -0,0 +1,51 @@
+// tela_nula.c
+// entrada e saída no terminal físico, sem terminal físico
+// simulador de computador
+// so24b
+
+// implementação de tela.h que não desenha nada, para executar a simulação
+//   sem curses (em um servidor, ou para medir desempenho)
+// não tem teclado: tela_tecla sempre retorna '\n', então a console não fica
+//   esperando o operador no final
+// a console sabe que não tem tela (tela_existe), e não perde tempo desenhando;
+//   os comandos do operador podem vir de um script (ver console.h)
+
+#include "tela.h"
+
+void tela_init(void)
+{
+}
+
+bool tela_existe(void)
+{
+  return false;
+}
+
+void tela_fim()
+{
+}
+
+void tela_espera(int ms)
+{
+}
+
+void tela_posiciona(int lin, int col)
+{
+}
+
+void tela_puts(int cor, char *str)
+{
+}
+
+void tela_limpa_linha()
+{
+}
+
+char tela_tecla(void)
+{
+  return '\n';
+}
+
+void tela_atualiza()
+{
+}
@@ -9,6 +9,9 @@
 #include <string.h>
 #include <assert.h>
 
+// número de linhas guardadas no histórico do modo instantâneo
+#define N_HISTORICO 100
+
 // TERMINAL
 
 // dados para cada terminal
@@ -16,7 +19,13 @@ struct terminal_t {
   // número de caracteres que cabem em uma linha
   int tam_linha;
   // texto já digitado no terminal, esperando para ser lido
+  // é uma fila circular, com 'n_entrada' caracteres a partir de 'ini_entrada'
   char *entrada;
+  int tam_entrada;
+  int ini_entrada;
+  int n_entrada;
+  // cópia do início da entrada, para mostrar na console
+  char *txt_entrada;
   // texto sendo mostrado na saída do terminal
   char *saida;
   // normal: aceitando novos caracteres na saída
@@ -32,22 +41,46 @@ struct terminal_t {
   enum { normal, rolando, limpando } estado_saida;
   // posicao do caractere que está sendo movido durante uma rolagem
   int pos_rolagem;
+  terminal_modo_t modo;
+  // modo instantâneo: número de caracteres na saída, e histórico, uma fila
+  //   circular de linhas ('n_historico' linhas, a mais recente em
+  //   'ult_historico')
+  int tam_saida;
+  char *historico;
+  int n_historico;
+  int ult_historico;
+  // onde copiar a saída (NULL se não copia)
+  FILE *copia_saida;
+  // controlador de interrupções (NULL se não tem)
+  pic_t *pic;
 };
 
 
-terminal_t *terminal_cria(int tam_linha)
+terminal_t *terminal_cria(int tam_linha, int tam_entrada)
 {
   terminal_t *self = malloc(sizeof(*self));
   assert(self != NULL);
 
   self->saida = malloc(tam_linha + 1);
-  self->entrada = malloc(tam_linha + 1);
-  assert(self->saida != NULL && self->entrada != NULL);
+  self->entrada = malloc(tam_entrada);
+  self->txt_entrada = malloc(tam_linha + 1);
+  self->historico = malloc(N_HISTORICO * (tam_linha + 1));
+  assert(self->saida != NULL && self->entrada != NULL && self->txt_entrada != NULL);
+  assert(self->historico != NULL);
 
   self->tam_linha = tam_linha;
-  strcpy(self->entrada, "");
+  self->tam_entrada = tam_entrada;
+  self->ini_entrada = 0;
+  self->n_entrada = 0;
+  strcpy(self->txt_entrada, "");
   strcpy(self->saida, "");
   self->estado_saida = normal;
+  self->modo = terminal_animado;
+  self->tam_saida = 0;
+  self->n_historico = 0;
+  self->ult_historico = 0;
+  self->copia_saida = NULL;
+  self->pic = NULL;
 
   return self;
 }
@@ -55,33 +88,49 @@ terminal_t *terminal_cria(int tam_linha)
 void terminal_destroi(terminal_t *self)
 {
   free(self->entrada);
+  free(self->txt_entrada);
+  free(self->historico);
   free(self->saida);
   free(self);
 }
 
+void terminal_define_pic(terminal_t *self, pic_t *pic)
+{
+  self->pic = pic;
+}
+
+static void terminal_pede_interrupcao(terminal_t *self, irq_t irq)
+{
+  if (self->pic != NULL) pic_pede(self->pic, irq);
+}
+
 static bool terminal_entrada_vazia(terminal_t *self)
 {
-  return self->entrada[0] == '\0';
+  return self->n_entrada == 0;
 }
 
 static char terminal_le_char(terminal_t *self)
 {
-  char *p = self->entrada;
-  char ch = p[0];
-  if (ch != '\0') {
-    memmove(&p[0], &p[1], strlen(p));
-  }
+  if (terminal_entrada_vazia(self)) return '\0';
+  char ch = self->entrada[self->ini_entrada];
+  self->ini_entrada = (self->ini_entrada + 1) % self->tam_entrada;
+  self->n_entrada--;
   return ch;
 }
 
+int terminal_espaco_entrada(terminal_t *self)
+{
+  return self->tam_entrada - self->n_entrada;
+}
+
 void terminal_insere_char(terminal_t *self, char ch)
 {
-  char *p = self->entrada;
-  int tam = strlen(p);
   // se não cabe, ignora silenciosamente
-  if (tam >= self->tam_linha-2) return;
-  p[tam] = ch;
-  p[tam+1] = '\0';
+  if (self->n_entrada >= self->tam_entrada) return;
+  int pos = (self->ini_entrada + self->n_entrada) % self->tam_entrada;
+  self->entrada[pos] = ch;
+  self->n_entrada++;
+  terminal_pede_interrupcao(self, IRQ_TECLADO);
 }
 
 static bool terminal_pode_imprimir(terminal_t *self)
@@ -89,8 +138,37 @@ static bool terminal_pode_imprimir(terminal_t *self)
   return self->estado_saida == normal;
 }
 
+// modo instantâneo: coloca a linha de saída no histórico e esvazia a saída
+static void terminal_guarda_linha(terminal_t *self)
+{
+  self->ult_historico = (self->ult_historico + 1) % N_HISTORICO;
+  if (self->n_historico < N_HISTORICO) self->n_historico++;
+  memcpy(&self->historico[self->ult_historico * (self->tam_linha + 1)],
+         self->saida, self->tam_saida + 1);
+  self->saida[0] = '\0';
+  self->tam_saida = 0;
+}
+
+static void terminal_imprime_instantaneo(terminal_t *self, char ch)
+{
+  if (ch == '\n') {
+    terminal_guarda_linha(self);
+    return;
+  }
+  self->saida[self->tam_saida++] = ch;
+  self->saida[self->tam_saida] = '\0';
+  if (self->tam_saida >= self->tam_linha - 1) {
+    terminal_guarda_linha(self);
+  }
+}
+
 static void terminal_imprime(terminal_t *self, char ch)
 {
+  if (self->copia_saida != NULL) fputc(ch, self->copia_saida);
+  if (self->modo == terminal_instantaneo) {
+    terminal_imprime_instantaneo(self, ch);
+    return;
+  }
   if (terminal_pode_imprimir(self)) {
     if (ch == '\n') {
       self->estado_saida = limpando;
@@ -107,10 +185,49 @@ static void terminal_imprime(terminal_t *self, char ch)
   }
 }
 
+// a saída volta a aceitar caracteres
+static void terminal_saida_normal(terminal_t *self)
+{
+  if (self->estado_saida == normal) return;
+  self->estado_saida = normal;
+  terminal_pede_interrupcao(self, IRQ_TELA);
+}
+
 void terminal_limpa_saida(terminal_t *self)
 {
   self->saida[0] = '\0';
-  self->estado_saida = normal;
+  self->tam_saida = 0;
+  terminal_saida_normal(self);
+}
+
+void terminal_define_modo(terminal_t *self, terminal_modo_t modo)
+{
+  // uma rolagem ou limpeza em andamento é abandonada
+  self->modo = modo;
+  terminal_saida_normal(self);
+  self->tam_saida = strlen(self->saida);
+}
+
+void terminal_define_copia_saida(terminal_t *self, FILE *arq)
+{
+  self->copia_saida = arq;
+}
+
+terminal_modo_t terminal_modo(terminal_t *self)
+{
+  return self->modo;
+}
+
+int terminal_n_historico(terminal_t *self)
+{
+  return self->n_historico;
+}
+
+char *terminal_historico(terminal_t *self, int i)
+{
+  assert(i >= 0 && i < self->n_historico);
+  int l = (self->ult_historico - i + N_HISTORICO) % N_HISTORICO;
+  return &self->historico[l * (self->tam_linha + 1)];
 }
 
 static void terminal_atualiza_rolagem(terminal_t *self)
@@ -123,7 +240,7 @@ static void terminal_atualiza_rolagem(terminal_t *self)
     self->pos_rolagem++;
     p[self->pos_rolagem] = ' ';
   } else {
-    self->estado_saida = normal;
+    terminal_saida_normal(self);
   }
 }
 
@@ -134,7 +251,7 @@ static void terminal_atualiza_limpeza(terminal_t *self)
   int tam = strlen(p);
   memmove(p, p+1, tam);
   if (tam <= 1) {
-    self->estado_saida = normal;
+    terminal_saida_normal(self);
   }
 }
 
@@ -155,7 +272,13 @@ void terminal_tictac(terminal_t *self)
 
 char *terminal_txt_entrada(terminal_t *self)
 {
-  return self->entrada;
+  // deixa espaço para o cursor
+  int n = self->n_entrada < self->tam_linha - 1 ? self->n_entrada : self->tam_linha - 1;
+  for (int i = 0; i < n; i++) {
+    self->txt_entrada[i] = self->entrada[(self->ini_entrada + i) % self->tam_entrada];
+  }
+  self->txt_entrada[n] = '\0';
+  return self->txt_entrada;
 }
 
 char *terminal_txt_saida(terminal_t *self)
@@ -18,30 +18,53 @@
 // - leitura do estado da saída (se um caractere pode ser escrito ou não)
 //
 // a leitura não é possível quando não existir caractere na entrada
-// existe um limite para caracteres digitados e não lidos; caracteres adicionais
-//   são ignorados
+// existe um limite para caracteres digitados e não lidos (definido na criação
+//   do terminal); caracteres adicionais são ignorados
 // o número de caracteres na saída é limitado ao tamanho da linha. um caractere
 //   adicional causa a "rolagem", que remove o primeiro caractere da linha para
 //   gerar espaço para o novo. a impressão de um \n causa a "limpeza" da linha.
 // a escrita não é possível se a saída estiver rolando ou sendo limpa, o que é
 //   feito um caractere por vez (a cada chamada a tictac).
+// no modo instantâneo, não tem rolagem nem limpeza: quando a linha enche ou
+//   recebe um \n, ela vai para o histórico do terminal (as últimas linhas
+//   completas) e a saída fica vazia na hora; a escrita é sempre possível.
 //
 // a E/S efetiva é realizada pela console. ela obtém acesso às linhas de entrada e
 //   saída chamando terminal_txt_entrada ou terminal_txt_saida. a console insere
 //   caracteres digitados no terminal chamando terminal_insere_char, e limpa a
 //   linha de saída com terminal_limpa_saida.
+//
+// se tiver um controlador de interrupções (terminal_define_pic), o terminal
+//   pede IRQ_TECLADO quando um caractere é inserido na entrada e IRQ_TELA
+//   quando a saída volta a aceitar caracteres depois de uma rolagem ou limpeza.
+//   a linha é a mesma para todos os terminais; quem trata a interrupção
+//   consulta o estado de cada um.
 
 #include <stdbool.h>
+#include <stdio.h>
 #include "es.h"
+#include "pic.h"
 
 typedef struct terminal_t terminal_t;
 
-// aloca e inicializa um novo terminal
-terminal_t *terminal_cria(int tam_linha);
+// modos da saída do terminal
+typedef enum {
+  terminal_animado,      // rolagem e limpeza um caractere por vez
+  terminal_instantaneo,  // linhas completas vão direto para o histórico
+} terminal_modo_t;
+
+// aloca e inicializa um novo terminal, com linhas de 'tam_linha' caracteres e
+//   espaço para 'tam_entrada' caracteres digitados e ainda não lidos
+terminal_t *terminal_cria(int tam_linha, int tam_entrada);
 // libera a memória ocupada por um terminal
 void terminal_destroi(terminal_t *self);
 
+// define o controlador de interrupções onde o terminal pede interrupção
+//   (NULL, o inicial, para não pedir)
+void terminal_define_pic(terminal_t *self, pic_t *pic);
+
 // retorna a linha de entrada do terminal (para uso pela console)
+// contém os primeiros caracteres a serem lidos que cabem na linha
 char *terminal_txt_entrada(terminal_t *self);
 
 // retorna a linha de saida do terminal (para uso pela console)
@@ -54,6 +77,24 @@ void terminal_insere_char(terminal_t *self, char ch);
 // limpa a linha de saída (para uso pela console)
 void terminal_limpa_saida(terminal_t *self);
 
+// número de caracteres que ainda cabem na entrada
+int terminal_espaco_entrada(terminal_t *self);
+
+// define um arquivo onde é copiado cada caractere escrito na saída (NULL
+//   para não copiar); o arquivo continua sendo de quem chamou
+void terminal_define_copia_saida(terminal_t *self, FILE *arq);
+
+// altera o modo da saída do terminal (o inicial é terminal_animado)
+void terminal_define_modo(terminal_t *self, terminal_modo_t modo);
+terminal_modo_t terminal_modo(terminal_t *self);
+
+// número de linhas no histórico (só tem histórico no modo instantâneo)
+// (para uso pela console, que mostra a última linha e o histórico com 'H')
+int terminal_n_historico(terminal_t *self);
+
+// retorna uma linha do histórico: 0 é a mais recente
+char *terminal_historico(terminal_t *self, int i);
+
 // esta função deve ser chamada periodicamente
 void terminal_tictac(terminal_t *self);
 
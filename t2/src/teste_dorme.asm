@@ -0,0 +1,95 @@
+; teste_dorme.asm
+; teste de SO_DORME, executado como processo inicial (ver 'make testes')
+; cria três processos (teste_dorme_f), que recebem pelo pipe 0 quanto tempo
+;   dormir e uma letra; cada um envia a sua letra pelo pipe 1 quando acorda,
+;   e quem dorme menos acorda primeiro, mesmo tendo sido criado depois; o
+;   pipe 1 chega ao fim quando todos terminam
+; saída esperada: abc
+
+SO_ESCR        define 2
+SO_CRIA_PROC   define 7
+SO_MATA_PROC   define 8
+SO_ESCR_STR    define 10
+SO_PIPE        define 12
+SO_ENVIA       define 13
+SO_RECEBE      define 14
+
+         ; pipe 0 com os pedidos, pipe 1 com as respostas
+         cargi SO_PIPE
+         chamas
+         desvnz erro
+         cargi SO_PIPE
+         chamas
+         sub um
+         desvnz erro
+         cargi pedidos
+         trax
+         cargi SO_ENVIA
+         chamas
+         desvn erro
+         cargi 0
+         armm n
+cria     cargi filho
+         trax
+         cargi SO_CRIA_PROC
+         chamas
+         desvn erro
+         cargm n
+         soma um
+         armm n
+         sub tres
+         desvnz cria
+         ; recebe as letras até o fim do pipe (todos os filhos terminaram)
+recebe   cargi vet
+         trax
+         cargi SO_RECEBE
+         chamas
+         desvn erro
+         desvz morre
+         trax
+         cargi 0
+         armx dados
+         cargi dados
+         chama impstr
+         desv recebe
+erro     cargi msg_erro
+         chama impstr
+morre    cargi 10
+         chama impch
+         cargi 0
+         trax
+         cargi SO_MATA_PROC
+         chamas
+
+; imprime a string que inicia em A (destroi X)
+impstr   espaco 1
+         trax
+         cargi SO_ESCR_STR
+         chamas
+         ret impstr
+
+; imprime o caractere em A (destroi X)
+impch    espaco 1
+         trax
+         cargi SO_ESCR
+         chamas
+         ret impch
+
+filho    string 'teste_dorme_f.maq'
+msg_erro string 'ERRO'
+n        espaco 1
+um       valor 1
+tres     valor 3
+; pipe 0: tempo e letra para cada filho, na ordem de criação
+pedidos  valor 0
+         valor 6
+         valor 6000
+         valor 'c'
+         valor 2000
+         valor 'a'
+         valor 4000
+         valor 'b'
+; pipe 1, até 3 valores
+vet      valor 1
+         valor 3
+dados    espaco 4
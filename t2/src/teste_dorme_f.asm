@@ -0,0 +1,49 @@
+; teste_dorme_f.asm
+; filho de teste_dorme: recebe do pipe 0 o tempo e a letra, dorme esse tempo
+;   e envia a letra pelo pipe 1
+; antes de dormir, envia 0 valores pelo pipe 1, para já ser um escritor dele
+;   (senão, o pipe chegaria ao fim quando o primeiro filho terminasse)
+
+SO_MATA_PROC   define 8
+SO_ENVIA       define 13
+SO_RECEBE      define 14
+SO_DORME       define 21
+
+         cargi pedido
+         trax
+         cargi SO_RECEBE
+         chamas
+         sub dois
+         desvnz morre
+         cargi anuncio
+         trax
+         cargi SO_ENVIA
+         chamas
+         cargm tempo
+         trax
+         cargi SO_DORME
+         chamas
+         cargm letra
+         armm resposta
+         cargi vet
+         trax
+         cargi SO_ENVIA
+         chamas
+morre    cargi 0
+         trax
+         cargi SO_MATA_PROC
+         chamas
+
+dois     valor 2
+; pipe 0, 2 valores: tempo e letra
+pedido   valor 0
+         valor 2
+tempo    espaco 1
+letra    espaco 1
+; pipe 1, nenhum valor
+anuncio  valor 1
+         valor 0
+; pipe 1, 1 valor
+vet      valor 1
+         valor 1
+resposta espaco 1
@@ -0,0 +1,73 @@
+; teste_futex.asm
+; teste de futex (SO_FUTEX_ESPERA, SO_FUTEX_ACORDA), executado como processo
+;   inicial (ver 'make testes')
+; mapeia o segmento 'fx' em 500 e cria um processo (teste_futex_f) que dorme,
+;   muda o valor do futex para 1 e acorda quem espera; espera no futex enquanto
+;   o valor for 0 e confere o valor
+; saída esperada: futex ok
+
+SO_ESCR           define 2
+SO_CRIA_PROC      define 7
+SO_MATA_PROC      define 8
+SO_ESCR_STR       define 10
+SO_SHM            define 15
+SO_FUTEX_ESPERA   define 19
+
+FUTEX    define 500
+
+         cargi vet_shm
+         trax
+         cargi SO_SHM
+         chamas
+         desvnz erro
+         cargi filho
+         trax
+         cargi SO_CRIA_PROC
+         chamas
+         desvn erro
+         ; espera até o valor deixar de ser 0 (acordar não garante isso)
+espera   cargi vet_futex
+         trax
+         cargi SO_FUTEX_ESPERA
+         chamas
+         desvn erro
+         cargm FUTEX
+         desvz espera
+         sub um
+         desvnz erro
+         cargi msg_ok
+         chama impstr
+         desv morre
+erro     cargi msg_erro
+         chama impstr
+morre    cargi 10
+         chama impch
+         cargi 0
+         trax
+         cargi SO_MATA_PROC
+         chamas
+
+; imprime a string que inicia em A (destroi X)
+impstr   espaco 1
+         trax
+         cargi SO_ESCR_STR
+         chamas
+         ret impstr
+
+; imprime o caractere em A (destroi X)
+impch    espaco 1
+         trax
+         cargi SO_ESCR
+         chamas
+         ret impch
+
+filho     string 'teste_futex_f.maq'
+msg_ok    string 'futex ok'
+msg_erro  string 'futex ERRO'
+um        valor 1
+vet_shm   valor FUTEX
+          valor 10
+          string 'fx'
+; endereço do futex e valor esperado
+vet_futex valor FUTEX
+          valor 0
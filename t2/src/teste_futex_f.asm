@@ -0,0 +1,38 @@
+; teste_futex_f.asm
+; filho de teste_futex: mapeia o segmento 'fx' em 600 (outro endereço que o
+;   do pai, mas o mesmo futex), dorme um pouco para o pai esperar, muda o
+;   valor do futex para 1 e acorda um processo
+
+SO_MATA_PROC      define 8
+SO_SHM            define 15
+SO_FUTEX_ACORDA   define 20
+SO_DORME          define 21
+
+FUTEX    define 600
+
+         cargi vet_shm
+         trax
+         cargi SO_SHM
+         chamas
+         desvnz morre
+         cargi 500
+         trax
+         cargi SO_DORME
+         chamas
+         cargi 1
+         armm FUTEX
+         cargi vet_futex
+         trax
+         cargi SO_FUTEX_ACORDA
+         chamas
+morre    cargi 0
+         trax
+         cargi SO_MATA_PROC
+         chamas
+
+vet_shm   valor FUTEX
+          valor 10
+          string 'fx'
+; endereço do futex e número de processos a acordar
+vet_futex valor FUTEX
+          valor 1
@@ -0,0 +1,53 @@
+; teste_linha.asm
+; teste de SO_LE_LINHA, executado como processo inicial com o script
+;   teste_linha.script (ver 'make testes')
+; lê linhas de no máximo 5 caracteres do terminal até uma linha vazia, e
+;   escreve cada uma seguida de '|'; uma linha com exatamente o máximo não
+;   deixa uma linha vazia para trás, e uma maior é entregue em pedaços
+; saída esperada: abcde|xy|abcde|fgh|
+
+SO_ESCR        define 2
+SO_MATA_PROC   define 8
+SO_ESCR_STR    define 10
+SO_LE_LINHA    define 11
+
+le       cargi vet
+         trax
+         cargi SO_LE_LINHA
+         chamas
+         desvn erro
+         ; linha vazia: fim
+         desvz morre
+         cargi linha
+         chama impstr
+         cargi barra
+         chama impstr
+         desv le
+erro     cargi msg_erro
+         chama impstr
+morre    cargi 10
+         chama impch
+         cargi 0
+         trax
+         cargi SO_MATA_PROC
+         chamas
+
+; imprime a string que inicia em A (destroi X)
+impstr   espaco 1
+         trax
+         cargi SO_ESCR_STR
+         chamas
+         ret impstr
+
+; imprime o caractere em A (destroi X)
+impch    espaco 1
+         trax
+         cargi SO_ESCR
+         chamas
+         ret impch
+
+msg_erro string 'ERRO'
+barra    string '|'
+; no máximo 5 caracteres, terminados por 0
+vet      valor 5
+linha    espaco 6
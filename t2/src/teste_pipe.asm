@@ -0,0 +1,90 @@
+; teste_pipe.asm
+; teste de pipes (SO_PIPE, SO_ENVIA, SO_RECEBE), executado como processo
+;   inicial (ver 'make testes')
+; cria um pipe e um processo (teste_pipe_f) que envia valores por ele, recebe
+;   até o fim (quando o filho termina) e escreve o que recebeu; depois cria
+;   pipes até dar erro, e confere que o limite é N_PIPES (16, em so.c)
+; saída esperada: abcdefg|fim|limite
+
+SO_ESCR        define 2
+SO_CRIA_PROC   define 7
+SO_MATA_PROC   define 8
+SO_ESCR_STR    define 10
+SO_PIPE        define 12
+SO_RECEBE      define 14
+
+         ; o primeiro pipe tem o número 0, que o filho usa
+         cargi SO_PIPE
+         chamas
+         desvnz erro
+         cargi filho
+         trax
+         cargi SO_CRIA_PROC
+         chamas
+         desvn erro
+recebe   cargi vet
+         trax
+         cargi SO_RECEBE
+         chamas
+         desvn erro
+         ; 0 valores: o pipe chegou ao fim
+         desvz fim
+         ; termina os valores recebidos com 0 e escreve
+         trax
+         cargi 0
+         armx dados
+         cargi dados
+         chama impstr
+         desv recebe
+fim      cargi msg_fim
+         chama impstr
+         ; já existe um pipe; cria até dar erro
+         cargi 1
+         armm n
+cria     cargi SO_PIPE
+         chamas
+         desvn limite
+         cargm n
+         soma um
+         armm n
+         desv cria
+limite   cargm n
+         sub max_pipes
+         desvnz erro
+         cargi msg_limite
+         chama impstr
+         desv morre
+erro     cargi msg_erro
+         chama impstr
+morre    cargi 10
+         chama impch
+         cargi 0
+         trax
+         cargi SO_MATA_PROC
+         chamas
+
+; imprime a string que inicia em A (destroi X)
+impstr   espaco 1
+         trax
+         cargi SO_ESCR_STR
+         chamas
+         ret impstr
+
+; imprime o caractere em A (destroi X)
+impch    espaco 1
+         trax
+         cargi SO_ESCR
+         chamas
+         ret impch
+
+filho      string 'teste_pipe_f.maq'
+msg_fim    string '|fim'
+msg_limite string '|limite'
+msg_erro   string '|ERRO'
+n          espaco 1
+um         valor 1
+max_pipes  valor 16
+; pipe 0, até 10 valores
+vet        valor 0
+           valor 10
+dados      espaco 11
@@ -0,0 +1,26 @@
+; teste_pipe_f.asm
+; filho de teste_pipe: envia duas mensagens pelo pipe 0 e termina
+
+SO_MATA_PROC   define 8
+SO_ENVIA       define 13
+
+         cargi vet1
+         trax
+         cargi SO_ENVIA
+         chamas
+         cargi vet2
+         trax
+         cargi SO_ENVIA
+         chamas
+         cargi 0
+         trax
+         cargi SO_MATA_PROC
+         chamas
+
+; pipe 0, número de valores, valores
+vet1     valor 0
+         valor 3
+         string 'abc'
+vet2     valor 0
+         valor 4
+         string 'defg'
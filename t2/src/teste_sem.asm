@@ -0,0 +1,109 @@
+; teste_sem.asm
+; teste de semáforos (SO_SEM_CRIA, SO_SEM_P, SO_SEM_V) e memória
+;   compartilhada (SO_SHM), executado como processo inicial (ver 'make testes')
+; mapeia o segmento 'cont' em 500, cria um semáforo de exclusão mútua (0) e um
+;   de término (1), e dois processos (teste_sem_f) que somam 1 ao contador no
+;   segmento 20 vezes cada, com uma demora entre ler e escrever; espera os dois
+;   pelo semáforo de término e confere o contador
+; saída esperada: sem 40
+
+SO_ESCR        define 2
+SO_CRIA_PROC   define 7
+SO_MATA_PROC   define 8
+SO_ESCR_STR    define 10
+SO_SHM         define 15
+SO_SEM_CRIA    define 16
+SO_SEM_P       define 17
+
+CONT     define 500
+
+         cargi vet_shm
+         trax
+         cargi SO_SHM
+         chamas
+         desvnz erro
+         ; mutex, semáforo 0, começa em 1
+         cargi 1
+         trax
+         cargi SO_SEM_CRIA
+         chamas
+         desvnz erro
+         ; término, semáforo 1, começa em 0
+         cargi 0
+         trax
+         cargi SO_SEM_CRIA
+         chamas
+         sub um
+         desvnz erro
+         cargi filho
+         trax
+         cargi SO_CRIA_PROC
+         chamas
+         desvn erro
+         cargi filho
+         trax
+         cargi SO_CRIA_PROC
+         chamas
+         desvn erro
+         ; espera os dois terminarem a contagem
+         cargi 1
+         trax
+         cargi SO_SEM_P
+         chamas
+         desvnz erro
+         cargi 1
+         trax
+         cargi SO_SEM_P
+         chamas
+         desvnz erro
+         cargi msg_sem
+         chama impstr
+         cargm CONT
+         chama impnum
+         desv morre
+erro     cargi msg_erro
+         chama impstr
+morre    cargi 10
+         chama impch
+         cargi 0
+         trax
+         cargi SO_MATA_PROC
+         chamas
+
+; imprime a string que inicia em A (destroi X)
+impstr   espaco 1
+         trax
+         cargi SO_ESCR_STR
+         chamas
+         ret impstr
+
+; imprime o caractere em A (destroi X)
+impch    espaco 1
+         trax
+         cargi SO_ESCR
+         chamas
+         ret impch
+
+; imprime o valor de A (0 a 99) em decimal (destroi X)
+impnum   espaco 1
+         armm num
+         div dez
+         soma a_zero
+         chama impch
+         cargm num
+         resto dez
+         soma a_zero
+         chama impch
+         ret impnum
+
+filho    string 'teste_sem_f.maq'
+msg_sem  string 'sem '
+msg_erro string 'ERRO'
+num      espaco 1
+um       valor 1
+dez      valor 10
+a_zero   valor '0'
+; endereço, tamanho e nome do segmento
+vet_shm  valor CONT
+         valor 10
+         string 'cont'
@@ -0,0 +1,60 @@
+; teste_sem_f.asm
+; filho de teste_sem: mapeia o segmento 'cont' em 600 (outro endereço que o
+;   do pai) e soma 1 ao contador 20 vezes, com o semáforo 0 em volta; no fim,
+;   faz V no semáforo 1
+
+SO_MATA_PROC   define 8
+SO_SHM         define 15
+SO_SEM_P       define 17
+SO_SEM_V       define 18
+
+CONT     define 600
+
+         cargi vet_shm
+         trax
+         cargi SO_SHM
+         chamas
+         desvnz morre
+         cargi 20
+         armm n
+laco     cargi 0
+         trax
+         cargi SO_SEM_P
+         chamas
+         ; lê o contador, demora um pouco e escreve o valor + 1; sem o
+         ;   semáforo, os dois processos perderiam somas
+         cargm CONT
+         armm valor
+         cargi 0
+         trax
+demora   incx
+         cpxa
+         sub trinta
+         desvnz demora
+         cargm valor
+         soma um
+         armm CONT
+         cargi 0
+         trax
+         cargi SO_SEM_V
+         chamas
+         cargm n
+         sub um
+         armm n
+         desvnz laco
+         cargi 1
+         trax
+         cargi SO_SEM_V
+         chamas
+morre    cargi 0
+         trax
+         cargi SO_MATA_PROC
+         chamas
+
+n        espaco 1
+valor    espaco 1
+um       valor 1
+trinta   valor 30
+vet_shm  valor CONT
+         valor 10
+         string 'cont'
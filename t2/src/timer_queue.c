@@ -0,0 +1,55 @@
+#include "timer_queue.h"
+#include "heap.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+// A fila é um heap indexado sobre 'wake_time', com a posição em 'timer_index'.
+struct timer_queue {
+    Heap* heap;
+};
+
+static double timer_queue_key(void* item) {
+    return ((Process*) item)->wake_time;
+}
+
+static int* timer_queue_index(void* item) {
+    return &((Process*) item)->timer_index;
+}
+
+TimerQueue* timer_queue_create(void) {
+    TimerQueue* queue = malloc(sizeof(TimerQueue));
+    assert(queue);
+    queue->heap = heap_create(timer_queue_key, timer_queue_index);
+    return queue;
+}
+
+void timer_queue_destroy(TimerQueue* queue) {
+    heap_destroy(queue->heap);
+    free(queue);
+}
+
+int timer_queue_size(TimerQueue* queue) {
+    return heap_size(queue->heap);
+}
+
+void timer_queue_push(TimerQueue* queue, Process* proc, int wake_time) {
+    proc->wake_time = wake_time;
+    heap_push(queue->heap, proc);
+}
+
+int timer_queue_next(TimerQueue* queue) {
+    Process* proc = heap_peek(queue->heap);
+    return proc == NULL ? -1 : proc->wake_time;
+}
+
+void timer_queue_remove(TimerQueue* queue, Process* proc) {
+    heap_remove(queue->heap, proc);
+}
+
+Process* timer_queue_pop_expired(TimerQueue* queue, int now) {
+    Process* proc = heap_peek(queue->heap);
+    if (proc == NULL || proc->wake_time > now) return NULL;
+    heap_remove(queue->heap, proc);
+    return proc;
+}
@@ -0,0 +1,31 @@
+#ifndef TIMER_QUEUE_H
+#define TIMER_QUEUE_H
+
+#include "process.h"
+
+// Processos dormindo, ordenados pelo instante em que devem acordar (heap
+//   mínimo sobre 'wake_time', em instruções executadas, ver heap.h).
+// Cada processo guarda sua posição no heap ('timer_index'), o que permite
+//   remover um processo qualquer em O(log n); empates saem na ordem de chegada.
+typedef struct timer_queue TimerQueue;
+
+TimerQueue* timer_queue_create(void);
+
+void timer_queue_destroy(TimerQueue* queue);
+
+int timer_queue_size(TimerQueue* queue);
+
+// Coloca o processo para acordar no instante 'wake_time'.
+void timer_queue_push(TimerQueue* queue, Process* proc, int wake_time);
+
+// Instante do próximo processo a acordar, -1 se a fila estiver vazia.
+int timer_queue_next(TimerQueue* queue);
+
+// Retira o próximo processo se o instante dele já chegou ('now'); senão
+//   retorna NULL.
+Process* timer_queue_pop_expired(TimerQueue* queue, int now);
+
+// Não faz nada se o processo não estiver na fila.
+void timer_queue_remove(TimerQueue* queue, Process* proc);
+
+#endif // TIMER_QUEUE_H
@@ -0,0 +1,87 @@
+#include "wait_queue.h"
+#include "pool.h"
+
+#include <stdlib.h>
+
+#define WAIT_QUEUE_POOL_SLAB 32
+
+typedef struct wait_node {
+    Process* proc;
+    struct wait_node* next;
+} Wait_Node;
+
+struct wait_queue {
+    Wait_Node* first;
+    Wait_Node* last;
+    int size;
+};
+
+// Nós (e filas) de todas as filas; criados na primeira fila e mantidos até
+//   wait_queue_destroy_pools.
+static Pool* wait_node_pool = NULL;
+static Pool* wait_queue_pool = NULL;
+
+void wait_queue_destroy_pools(void) {
+    if (wait_queue_pool) {
+        pool_destroy(wait_queue_pool);
+        pool_destroy(wait_node_pool);
+    }
+    wait_queue_pool = NULL;
+    wait_node_pool = NULL;
+}
+
+WaitQueue* wait_queue_create(void) {
+    if (wait_queue_pool == NULL) {
+        wait_queue_pool = pool_create(sizeof(WaitQueue), WAIT_QUEUE_POOL_SLAB);
+        wait_node_pool = pool_create(sizeof(Wait_Node), WAIT_QUEUE_POOL_SLAB);
+    }
+    WaitQueue* queue = pool_alloc(wait_queue_pool);
+    *queue = (WaitQueue) { .first = NULL, .last = NULL, .size = 0 };
+    return queue;
+}
+
+void wait_queue_destroy(WaitQueue* queue) {
+    while (queue->first) wait_queue_pop(queue);
+    pool_free(wait_queue_pool, queue);
+}
+
+int wait_queue_size(WaitQueue* queue) {
+    return queue->size;
+}
+
+void wait_queue_push(WaitQueue* queue, Process* proc) {
+    Wait_Node* node = pool_alloc(wait_node_pool);
+    *node = (Wait_Node) { .proc = proc, .next = NULL };
+
+    if (queue->last) queue->last->next = node;
+    else queue->first = node;
+    queue->last = node;
+    queue->size++;
+}
+
+Process* wait_queue_pop(WaitQueue* queue) {
+    Wait_Node* node = queue->first;
+    if (node == NULL) return NULL;
+
+    queue->first = node->next;
+    if (queue->first == NULL) queue->last = NULL;
+    queue->size--;
+
+    Process* proc = node->proc;
+    pool_free(wait_node_pool, node);
+    return proc;
+}
+
+void wait_queue_remove(WaitQueue* queue, Process* proc) {
+    Wait_Node* prev = NULL;
+    for (Wait_Node* node = queue->first; node; prev = node, node = node->next) {
+        if (node->proc != proc) continue;
+
+        if (prev) prev->next = node->next;
+        else queue->first = node->next;
+        if (queue->last == node) queue->last = prev;
+        queue->size--;
+        pool_free(wait_node_pool, node);
+        return;
+    }
+}
@@ -0,0 +1,30 @@
+#ifndef WAIT_QUEUE_H
+#define WAIT_QUEUE_H
+
+#include "process.h"
+
+// Fila de processos esperando por um recurso do SO (semáforo, futex).
+// Os nós da fila vêm de um pool (ver pool.h) compartilhado por todas as
+//   filas, então bloquear e acordar processos não usa malloc.
+typedef struct wait_queue WaitQueue;
+
+WaitQueue* wait_queue_create(void);
+
+void wait_queue_destroy(WaitQueue* queue);
+
+// Libera a memória dos pools das filas. Só pode ser chamada quando não existe
+//   nenhuma fila (o SO chama ao ser destruído); a próxima fila criada recria
+//   os pools.
+void wait_queue_destroy_pools(void);
+
+int wait_queue_size(WaitQueue* queue);
+
+void wait_queue_push(WaitQueue* queue, Process* proc);
+
+// Retorna o processo que espera há mais tempo, ou NULL se a fila estiver vazia.
+Process* wait_queue_pop(WaitQueue* queue);
+
+// Não faz nada se o processo não estiver na fila.
+void wait_queue_remove(WaitQueue* queue, Process* proc);
+
+#endif // WAIT_QUEUE_H